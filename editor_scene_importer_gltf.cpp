@@ -111,6 +111,15 @@ Node *PackedSceneGLTF::import_scene(const String &p_path, const PoolByteArray by
 		gltf_document->_generate_scene_node(r_state, root, root, r_state->root_nodes[root_i]);
 	}
 	gltf_document->_process_mesh_instances(r_state, root);
+	if (r_state->instance_repeated_meshes) {
+		gltf_document->_instance_repeated_meshes(r_state, root);
+	}
+	if (r_state->batch_static_meshes) {
+		gltf_document->_batch_static_meshes(r_state, root);
+	}
+	if (r_state->lazy_textures) {
+		gltf_document->_materialize_scene_images(r_state, root);
+	}
 	if (r_state->animations.size()) {
 		AnimationPlayer *ap = AnimationPlayer::_new();
 		root->add_child(ap);
@@ -32,23 +32,35 @@
 #include "gltf_accessor.h"
 #include "gltf_animation.h"
 #include "gltf_camera.h"
+#include "gltf_hash.h"
 #include "gltf_light.h"
 #include "gltf_mesh.h"
+#include "gltf_mipmaps.h"
 #include "gltf_node.h"
+#include "gltf_resource_registry.h"
 #include "gltf_skeleton.h"
 #include "gltf_skin.h"
 #include "gltf_spec_gloss.h"
 #include "gltf_state.h"
 #include "gltf_texture.h"
+#include "gltf_texture_bleed.h"
+#include "gltf_texture_cache.h"
 #include "vector.h"
 #include "list.h"
 #include "map.h"
 #include "disjoint_set.h"
+#include "mesh_simplifier.h"
+#include "thread_work_pool.h"
 #include "web_request.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <map>
+#include <set>
+#include <tuple>
 #include <cfloat>
 #include <limits>
 
@@ -60,6 +72,7 @@
 #include <DirectionalLight.hpp>
 #include <Directory.hpp>
 #include <File.hpp>
+#include <GlobalConstants.hpp>
 #include <GridMap.hpp>
 #include <Image.hpp>
 #include <ImageTexture.hpp>
@@ -74,6 +87,7 @@
 #include <Node2D.hpp>
 #include <OmniLight.hpp>
 #include <OS.hpp>
+#include <ProxyTexture.hpp>
 #include <ResourceLoader.hpp>
 #include <Skeleton.hpp>
 #include <SkinReference.hpp>
@@ -181,6 +195,8 @@ Ref<NativeScript> class_by_name(const char* type_name) {
 
 void GLTFDocument::_register_methods() {
 	register_method("_init", &GLTFDocument::_init);
+	register_method("prefetch_images", &GLTFDocument::prefetch_images);
+	register_method("materialize_images", &GLTFDocument::materialize_images);
 }
 
 bool GLTFDocument::class_references_leaked = false;
@@ -747,6 +763,33 @@ Error GLTFDocument::_parse_nodes(Ref<GLTFState> state) {
 					node->light = light;
 				}
 			}
+			if (extensions.has("EXT_mesh_gpu_instancing")) {
+				Dictionary instancing = extensions["EXT_mesh_gpu_instancing"];
+				if (instancing.has("attributes")) {
+					node->instancing_attributes = instancing["attributes"];
+				}
+			}
+			if (extensions.has("MSFT_lod")) {
+				Dictionary lod = extensions["MSFT_lod"];
+				if (lod.has("ids")) {
+					const Array &ids = lod["ids"];
+					for (int j = 0; j < ids.size(); j++) {
+						node->lods.push_back(ids[j]);
+					}
+				}
+				if (n.has("extras")) {
+					// One coverage per level, starting with this node itself. Each
+					// is the lowest coverage its level is shown at, so entry j
+					// is where lod j takes over.
+					const Dictionary &extras = n["extras"];
+					if (extras.has("MSFT_screencoverage")) {
+						const Array &coverage = extras["MSFT_screencoverage"];
+						for (int j = 0; j < coverage.size(); j++) {
+							node->lod_screen_coverage.push_back(coverage[j]);
+						}
+					}
+				}
+			}
 		}
 
 		if (n.has("children")) {
@@ -778,6 +821,17 @@ Error GLTFDocument::_parse_nodes(Ref<GLTFState> state) {
 
 void GLTFDocument::_compute_node_heights(Ref<GLTFState> state) {
 	state->root_nodes.clear();
+
+	// MSFT_lod levels are separate top-level nodes, but are only instanced
+	// through the node that references them.
+	Set<GLTFNodeIndex> lod_nodes;
+	for (GLTFNodeIndex node_i = 0; node_i < state->nodes.size(); ++node_i) {
+		const PoolIntArray &lods = state->nodes[node_i]->lods;
+		for (int i = 0; i < lods.size(); i++) {
+			lod_nodes.insert(lods[i]);
+		}
+	}
+
 	for (GLTFNodeIndex node_i = 0; node_i < state->nodes.size(); ++node_i) {
 		Ref<GLTFNode> node = state->nodes[node_i];
 		node->height = 0;
@@ -791,7 +845,7 @@ void GLTFDocument::_compute_node_heights(Ref<GLTFState> state) {
 			current_i = parent_i;
 		}
 
-		if (node->height == 0) {
+		if (node->height == 0 && !lod_nodes.has(node_i)) {
 			state->root_nodes.push_back(node_i);
 		}
 	}
@@ -2782,11 +2836,524 @@ Error GLTFDocument::_serialize_meshes(Ref<GLTFState> state) {
 	return OK;
 }
 
+bool GLTFDocument::_get_accessor_bounds(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, AABB &r_aabb) {
+	ERR_FAIL_INDEX_V(p_accessor, state->accessors.size(), false);
+	Ref<GLTFAccessor> accessor = state->accessors[p_accessor];
+	// Quantized accessors store their bounds before dequantization.
+	if (accessor->type != TYPE_VEC3 || accessor->component_type != COMPONENT_TYPE_FLOAT || accessor->min.size() != 3 || accessor->max.size() != 3) {
+		return false;
+	}
+	const Vector3 min(accessor->min[0], accessor->min[1], accessor->min[2]);
+	const Vector3 max(accessor->max[0], accessor->max[1], accessor->max[2]);
+	if (min.x > max.x || min.y > max.y || min.z > max.z) {
+		return false;
+	}
+	r_aabb = AABB(min, max - min);
+	return true;
+}
+
+bool GLTFDocument::_vertices_within_bounds(const PoolVector3Array &p_vertices, const AABB &p_aabb) {
+	// Writers round their bounds, so allow a little slack.
+	const AABB aabb = p_aabb.grow(MAX(p_aabb.get_longest_axis_size(), 1.0f) * 1e-4f);
+	const Vector3 min = aabb.position;
+	const Vector3 max = aabb.position + aabb.size;
+	const int vertex_count = p_vertices.size();
+	PoolVector3Array::Read r = p_vertices.read();
+	for (int i = 0; i < vertex_count; i++) {
+		const Vector3 &v = r[i];
+		if (v.x < min.x || v.y < min.y || v.z < min.z || v.x > max.x || v.y > max.y || v.z > max.z) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GLTFDocument::_reduce_bone_influences(const std::vector<PoolIntArray> &p_joint_sets, const std::vector<PoolRealArray> &p_weight_sets, int p_max_influences, PoolIntArray &r_joints, PoolRealArray &r_weights) {
+	const int INFLUENCES = 4;
+	ERR_FAIL_COND_V(p_joint_sets.empty() || p_joint_sets.size() != p_weight_sets.size(), false);
+	const int vertex_count = p_joint_sets[0].size() / INFLUENCES;
+	const int set_count = p_joint_sets.size();
+
+	std::vector<PoolIntArray::Read> joint_reads;
+	std::vector<PoolRealArray::Read> weight_reads;
+	std::vector<const int *> joints;
+	std::vector<const real_t *> weights;
+	joint_reads.reserve(set_count);
+	weight_reads.reserve(set_count);
+	for (int set_i = 0; set_i < set_count; set_i++) {
+		ERR_FAIL_COND_V(p_joint_sets[set_i].size() != vertex_count * INFLUENCES || p_weight_sets[set_i].size() != vertex_count * INFLUENCES, false);
+		joint_reads.push_back(p_joint_sets[set_i].read());
+		weight_reads.push_back(p_weight_sets[set_i].read());
+		joints.push_back(joint_reads.back().ptr());
+		weights.push_back(weight_reads.back().ptr());
+	}
+
+	r_joints.resize(vertex_count * INFLUENCES);
+	r_weights.resize(vertex_count * INFLUENCES);
+	PoolIntArray::Write joints_write = r_joints.write();
+	PoolRealArray::Write weights_write = r_weights.write();
+	int *out_joints = joints_write.ptr();
+	real_t *out_weights = weights_write.ptr();
+
+	for (int v = 0; v < vertex_count; v++) {
+		// Insertion into a small descending list; the common single set case
+		// only ever shifts within four slots.
+		int top_joints[INFLUENCES] = { 0, 0, 0, 0 };
+		real_t top_weights[INFLUENCES] = { 0, 0, 0, 0 };
+		for (int set_i = 0; set_i < set_count; set_i++) {
+			const int *src_joints = joints[set_i] + v * INFLUENCES;
+			const real_t *src_weights = weights[set_i] + v * INFLUENCES;
+			for (int k = 0; k < INFLUENCES; k++) {
+				const real_t weight = src_weights[k];
+				if (!(weight > 0.0f)) {
+					continue;
+				}
+				int slot = p_max_influences;
+				while (slot > 0 && top_weights[slot - 1] < weight) {
+					slot--;
+				}
+				if (slot >= p_max_influences) {
+					continue;
+				}
+				for (int m = p_max_influences - 1; m > slot; m--) {
+					top_weights[m] = top_weights[m - 1];
+					top_joints[m] = top_joints[m - 1];
+				}
+				top_weights[slot] = weight;
+				top_joints[slot] = src_joints[k];
+			}
+		}
+
+		const real_t total = top_weights[0] + top_weights[1] + top_weights[2] + top_weights[3];
+		const real_t scale = total > 0.0f ? 1.0f / total : 0.0f;
+		for (int k = 0; k < INFLUENCES; k++) {
+			out_joints[v * INFLUENCES + k] = top_joints[k];
+			out_weights[v * INFLUENCES + k] = top_weights[k] * scale;
+		}
+	}
+	return true;
+}
+
+// Padding around every atlas slot, filled by extending the texture's edges so
+// bilinear filtering doesn't pick up neighbouring textures. With a padding of
+// 2^n texels and slots aligned to it, the first n mip levels still keep the
+// textures apart. Each page picks n so that its smallest texture is at least
+// ATLAS_MIN_CLEAN_MIP_SIZE texels wide at the last clean level; the smaller
+// levels blend neighbours like any atlas.
+static const int ATLAS_MIN_PADDING_LEVELS = 2;
+static const int ATLAS_MAX_PADDING_LEVELS = 5;
+static const int ATLAS_MIN_CLEAN_MIP_SIZE = 4;
+
+// glTF sampler constants.
+static const int GLTF_SAMPLER_NEAREST = 9728;
+static const int GLTF_SAMPLER_LINEAR = 9729;
+static const int GLTF_SAMPLER_CLAMP_TO_EDGE = 33071;
+static const int GLTF_SAMPLER_MIRRORED_REPEAT = 33648;
+
+static int _get_sampler_texture_flags(const Dictionary &p_sampler) {
+	// Undefined filters and wraps are up to the implementation, they keep
+	// Godot's defaults.
+	int texture_flags = 0;
+	if (!p_sampler.has("magFilter") || (int)p_sampler["magFilter"] != GLTF_SAMPLER_NEAREST) {
+		texture_flags |= Texture::FLAG_FILTER;
+	}
+	if (!p_sampler.has("minFilter") || ((int)p_sampler["minFilter"] != GLTF_SAMPLER_NEAREST && (int)p_sampler["minFilter"] != GLTF_SAMPLER_LINEAR)) {
+		texture_flags |= Texture::FLAG_MIPMAPS;
+	}
+	// A single wrap mode covers both axes, any repeating axis wins.
+	const int wrap_s = p_sampler.has("wrapS") ? (int)p_sampler["wrapS"] : -1;
+	const int wrap_t = p_sampler.has("wrapT") ? (int)p_sampler["wrapT"] : -1;
+	if (wrap_s == GLTF_SAMPLER_MIRRORED_REPEAT || wrap_t == GLTF_SAMPLER_MIRRORED_REPEAT) {
+		texture_flags |= Texture::FLAG_MIRRORED_REPEAT;
+	} else if (wrap_s != GLTF_SAMPLER_CLAMP_TO_EDGE || wrap_t != GLTF_SAMPLER_CLAMP_TO_EDGE) {
+		texture_flags |= Texture::FLAG_REPEAT;
+	}
+	return texture_flags;
+}
+
+static int _atlas_padding(int p_min_side) {
+	int levels = ATLAS_MIN_PADDING_LEVELS;
+	while (levels < ATLAS_MAX_PADDING_LEVELS && (p_min_side >> (levels + 1)) >= ATLAS_MIN_CLEAN_MIP_SIZE) {
+		levels++;
+	}
+	return 1 << levels;
+}
+
+static int _atlas_slot_dimension(int p_texture_size, int p_padding) {
+	return (p_texture_size + p_padding * 3 - 1) / p_padding * p_padding;
+}
+
+// Pages are packed within a power of two page size, so rounding up never
+// makes them larger than atlas_page_size.
+static int _atlas_page_dimension(int p_used) {
+	int size = 1;
+	while (size < p_used) {
+		size <<= 1;
+	}
+	return size;
+}
+
+Error GLTFDocument::_build_texture_atlases(Ref<GLTFState> state) {
+	state->material_atlas.clear();
+	if (!state->json.has("materials") || !state->json.has("textures")) {
+		return OK;
+	}
+	if (state->lazy_textures) {
+		// Lazy textures have no pixels yet and can't be packed.
+		WARN_PRINT("glTF: Texture atlasing is not available with lazy textures.");
+		return OK;
+	}
+	int page_size = 1;
+	while (page_size * 2 <= state->atlas_page_size) {
+		page_size *= 2;
+	}
+	const int max_texture_size = MIN(state->atlas_max_texture_size, page_size - (1 << ATLAS_MIN_PADDING_LEVELS) * 2);
+	if (max_texture_size <= 0) {
+		return OK;
+	}
+
+	const Array &json_materials = state->json["materials"];
+	const Array &json_textures = state->json["textures"];
+	const Array json_samplers = state->json.has("samplers") ? (Array)state->json["samplers"] : Array();
+
+	// Only materials whose sole texture is an albedo texture on TEXCOORD_0
+	// are eligible. Materials that differ in nothing but that texture (and
+	// use the same filtering) are grouped, each group gets its own pages.
+	// Surfaces only use the atlas while their UVs stay within the texture, so
+	// the wrap mode doesn't matter.
+	struct AtlasCandidate {
+		GLTFMaterialIndex material = -1;
+		GLTFImageIndex image = -1;
+		int texture_flags = Texture::FLAG_MIPMAPS | Texture::FLAG_FILTER;
+	};
+	std::map<uint64_t, std::vector<AtlasCandidate>> groups;
+	std::map<GLTFImageIndex, Ref<Image>> image_data;
+	for (GLTFMaterialIndex i = 0; i < json_materials.size() && i < state->materials.size(); i++) {
+		const Dictionary &d = json_materials[i];
+		if (!d.has("pbrMetallicRoughness") || d.has("normalTexture") || d.has("occlusionTexture") || d.has("emissiveTexture")) {
+			continue;
+		}
+		if (d.has("extensions") && ((Dictionary)d["extensions"]).has("KHR_materials_pbrSpecularGlossiness")) {
+			continue;
+		}
+		const Dictionary &mr = d["pbrMetallicRoughness"];
+		if (!mr.has("baseColorTexture") || mr.has("metallicRoughnessTexture")) {
+			continue;
+		}
+		const Dictionary &bct = mr["baseColorTexture"];
+		if (!bct.has("index") || bct.has("extensions") || (bct.has("texCoord") && (int)bct["texCoord"] != 0)) {
+			continue;
+		}
+		const GLTFTextureIndex texture = bct["index"];
+		if (texture < 0 || texture >= state->textures.size() || texture >= json_textures.size()) {
+			continue;
+		}
+		const GLTFImageIndex image = state->textures[texture]->get_src_image();
+		if (image < 0 || image >= state->images.size() || state->images[image].is_null()) {
+			continue;
+		}
+		Ref<SpatialMaterial> material = state->materials[i];
+		if (material.is_null() || material->get_texture(SpatialMaterial::TEXTURE_ALBEDO) != state->images[image]) {
+			continue;
+		}
+		if (image_data.find(image) == image_data.end()) {
+			Ref<Image> data;
+			if (state->images[image]->get_width() <= max_texture_size && state->images[image]->get_height() <= max_texture_size) {
+				data = state->images[image]->get_data();
+			}
+			if (data.is_valid() && data->is_compressed()) {
+				data = Ref<Image>();
+			}
+			image_data[image] = data;
+		}
+		if (image_data[image].is_null()) {
+			continue;
+		}
+
+		AtlasCandidate candidate;
+		candidate.material = i;
+		candidate.image = image;
+		const Dictionary &t = json_textures[texture];
+		if (t.has("sampler")) {
+			const int sampler = t["sampler"];
+			if (sampler >= 0 && sampler < json_samplers.size()) {
+				candidate.texture_flags = _get_sampler_texture_flags(json_samplers[sampler]) & (Texture::FLAG_MIPMAPS | Texture::FLAG_FILTER);
+			}
+		}
+		Ref<SpatialMaterial> key_material = material->duplicate();
+		key_material->set_texture(SpatialMaterial::TEXTURE_ALBEDO, Ref<Texture>());
+		const uint64_t key = gltf_hash_int(candidate.texture_flags, _hash_material(key_material, std::map<const Object *, uint64_t>()));
+		groups[key].push_back(candidate);
+	}
+
+	// Shelf packing, tallest textures first, starting a new page whenever the
+	// current one is full.
+	struct AtlasSlot {
+		GLTFImageIndex image = -1;
+		int x = 0;
+		int y = 0;
+	};
+	struct AtlasPage {
+		std::vector<AtlasSlot> slots;
+		std::vector<AtlasCandidate> candidates;
+		int padding = 0;
+		int width = 0;
+		int height = 0;
+		Ref<Image> image;
+	};
+	std::vector<AtlasPage> pages;
+	for (std::map<uint64_t, std::vector<AtlasCandidate>>::iterator group = groups.begin(); group != groups.end(); ++group) {
+		const std::vector<AtlasCandidate> &candidates = group->second;
+		if (candidates.size() < 2) {
+			continue;
+		}
+		std::vector<GLTFImageIndex> group_images;
+		for (size_t candidate_i = 0; candidate_i < candidates.size(); candidate_i++) {
+			if (std::find(group_images.begin(), group_images.end(), candidates[candidate_i].image) == group_images.end()) {
+				group_images.push_back(candidates[candidate_i].image);
+			}
+		}
+		std::stable_sort(group_images.begin(), group_images.end(), [&](GLTFImageIndex a, GLTFImageIndex b) {
+			return image_data[a]->get_height() > image_data[b]->get_height();
+		});
+		int min_side = page_size;
+		for (size_t image_i = 0; image_i < group_images.size(); image_i++) {
+			min_side = MIN(min_side, MIN(image_data[group_images[image_i]]->get_width(), image_data[group_images[image_i]]->get_height()));
+		}
+		const int padding = _atlas_padding(min_side);
+
+		const size_t first_page = pages.size();
+		std::map<GLTFImageIndex, size_t> image_pages;
+		int shelf_x = page_size;
+		int shelf_y = 0;
+		int shelf_height = 0;
+		for (size_t image_i = 0; image_i < group_images.size(); image_i++) {
+			const Ref<Image> &data = image_data[group_images[image_i]];
+			const int slot_width = _atlas_slot_dimension(data->get_width(), padding);
+			const int slot_height = _atlas_slot_dimension(data->get_height(), padding);
+			if (slot_width > page_size || slot_height > page_size) {
+				continue;
+			}
+			if (shelf_x + slot_width > page_size) {
+				shelf_x = 0;
+				shelf_y += shelf_height;
+				shelf_height = slot_height;
+			}
+			if (pages.size() == first_page || shelf_y + slot_height > page_size) {
+				pages.push_back(AtlasPage());
+				pages.back().padding = padding;
+				shelf_x = 0;
+				shelf_y = 0;
+				shelf_height = slot_height;
+			}
+			AtlasPage &page = pages.back();
+			AtlasSlot slot;
+			slot.image = group_images[image_i];
+			slot.x = shelf_x;
+			slot.y = shelf_y;
+			page.slots.push_back(slot);
+			page.width = MAX(page.width, shelf_x + slot_width);
+			page.height = MAX(page.height, shelf_y + slot_height);
+			image_pages[slot.image] = pages.size() - 1;
+			shelf_x += slot_width;
+		}
+		for (size_t candidate_i = 0; candidate_i < candidates.size(); candidate_i++) {
+			const std::map<GLTFImageIndex, size_t>::const_iterator image_page = image_pages.find(candidates[candidate_i].image);
+			if (image_page != image_pages.end()) {
+				pages[image_page->second].candidates.push_back(candidates[candidate_i]);
+			}
+		}
+	}
+
+	// A page holding a single texture saves nothing.
+	std::vector<AtlasPage> used_pages;
+	for (size_t page_i = 0; page_i < pages.size(); page_i++) {
+		if (pages[page_i].slots.size() > 1) {
+			pages[page_i].width = _atlas_page_dimension(pages[page_i].width);
+			pages[page_i].height = _atlas_page_dimension(pages[page_i].height);
+			used_pages.push_back(pages[page_i]);
+		}
+	}
+	pages.swap(used_pages);
+
+	ThreadWorkPool::do_work(pages.size(), state->worker_thread_count, [&](int p_index) {
+		AtlasPage &page = pages[p_index];
+		PoolByteArray page_data;
+		page_data.resize(page.width * page.height * 4);
+		{
+			PoolByteArray::Write page_write = page_data.write();
+			uint8_t *dst = page_write.ptr();
+			memset(dst, 0, page_data.size());
+			const int padding = page.padding;
+			for (size_t slot_i = 0; slot_i < page.slots.size(); slot_i++) {
+				const AtlasSlot &slot = page.slots[slot_i];
+				Ref<Image> image = image_data.at(slot.image)->duplicate();
+				image->clear_mipmaps();
+				image->convert(Image::FORMAT_RGBA8);
+				const int width = image->get_width();
+				const int height = image->get_height();
+				const PoolByteArray image_data_rgba = image->get_data();
+				PoolByteArray::Read image_read = image_data_rgba.read();
+				const uint8_t *src = image_read.ptr();
+				// The edges are extended over the whole slot, alignment
+				// included.
+				const int slot_width = _atlas_slot_dimension(width, padding);
+				const int slot_height = _atlas_slot_dimension(height, padding);
+				for (int y = -padding; y < slot_height - padding; y++) {
+					const uint8_t *src_row = src + CLAMP(y, 0, height - 1) * width * 4;
+					uint8_t *dst_row = dst + ((slot.y + padding + y) * page.width + slot.x) * 4;
+					for (int x = 0; x < padding; x++) {
+						memcpy(dst_row + x * 4, src_row, 4);
+					}
+					memcpy(dst_row + padding * 4, src_row, width * 4);
+					for (int x = padding + width; x < slot_width; x++) {
+						memcpy(dst_row + x * 4, src_row + (width - 1) * 4, 4);
+					}
+				}
+			}
+		}
+		page.image.instance();
+		page.image->create_from_data(page.width, page.height, false, Image::FORMAT_RGBA8, page_data);
+		_generate_image_mipmaps(page.image, true, 1);
+	});
+
+	state->material_atlas.resize(state->materials.size());
+	int atlased_textures = 0;
+	int atlased_materials = 0;
+	for (size_t page_i = 0; page_i < pages.size(); page_i++) {
+		const AtlasPage &page = pages[page_i];
+		Ref<ImageTexture> texture;
+		texture.instance();
+		texture->create_from_image(page.image, page.candidates.front().texture_flags);
+		texture->set_name(str_format("{0}_atlas_{1}", state->scene_name, (int)page_i));
+
+		Ref<SpatialMaterial> material = state->materials[page.candidates.front().material]->duplicate();
+		material->set_texture(SpatialMaterial::TEXTURE_ALBEDO, texture);
+		material->set_name(str_format("{0}_atlas_material_{1}", state->scene_name, (int)page_i));
+
+		std::map<GLTFImageIndex, Rect2> uv_rects;
+		for (size_t slot_i = 0; slot_i < page.slots.size(); slot_i++) {
+			const AtlasSlot &slot = page.slots[slot_i];
+			const Ref<Image> &data = image_data[slot.image];
+			uv_rects[slot.image] = Rect2(
+					(float)(slot.x + page.padding) / page.width, (float)(slot.y + page.padding) / page.height,
+					(float)data->get_width() / page.width, (float)data->get_height() / page.height);
+		}
+		for (size_t candidate_i = 0; candidate_i < page.candidates.size(); candidate_i++) {
+			const AtlasCandidate &candidate = page.candidates[candidate_i];
+			GLTFAtlasEntry &entry = state->material_atlas[candidate.material];
+			entry.material = material;
+			entry.uv_rect = uv_rects[candidate.image];
+		}
+		atlased_textures += page.slots.size();
+		atlased_materials += page.candidates.size();
+	}
+
+	Dictionary stats;
+	stats["pages"] = (int)pages.size();
+	stats["textures"] = atlased_textures;
+	stats["materials"] = atlased_materials;
+	stats["surfaces"] = 0;
+	stats["surfaces_skipped"] = 0;
+	state->import_stats["atlas"] = stats;
+	print_verbose(str_format("glTF: Packed {0} textures of {1} materials into {2} atlas pages", atlased_textures, atlased_materials, (int)pages.size()));
+
+	return OK;
+}
+
+// Applies a baked KHR_texture_transform to TEXCOORD_0 of a surface and its
+// morph targets. Returns false when the surface has no UVs.
+static bool _bake_uv_transform(Array &r_array, Array &r_morphs, const Transform2D &p_transform) {
+	if (r_array[Mesh::ARRAY_TEX_UV].get_type() != Variant::POOL_VECTOR2_ARRAY) {
+		return false;
+	}
+	Array arrays;
+	arrays.push_back(r_array);
+	for (int morph_i = 0; morph_i < r_morphs.size(); morph_i++) {
+		arrays.push_back(r_morphs[morph_i]);
+	}
+	for (int array_i = 0; array_i < arrays.size(); array_i++) {
+		Array array = arrays[array_i];
+		if (array[Mesh::ARRAY_TEX_UV].get_type() != Variant::POOL_VECTOR2_ARRAY) {
+			continue;
+		}
+		PoolVector2Array uvs = array[Mesh::ARRAY_TEX_UV];
+		{
+			PoolVector2Array::Write uvs_write = uvs.write();
+			for (int uv_i = 0; uv_i < uvs.size(); uv_i++) {
+				uvs_write[uv_i] = p_transform.xform(uvs_write[uv_i]);
+			}
+		}
+		array[Mesh::ARRAY_TEX_UV] = uvs;
+	}
+	return true;
+}
+
+// Moves TEXCOORD_0 of a surface and its morph targets into the atlas region
+// of the surface's texture. Fails without changing anything when there are no
+// UVs, or any of them leaves the 0-1 range: the atlas can't reproduce repeat
+// or clamp-to-edge sampling outside the texture.
+static bool _remap_atlas_uvs(Array &r_array, Array &r_morphs, const GLTFAtlasEntry &p_entry) {
+	if (r_array[Mesh::ARRAY_TEX_UV].get_type() != Variant::POOL_VECTOR2_ARRAY) {
+		return false;
+	}
+	Array arrays;
+	arrays.push_back(r_array);
+	for (int morph_i = 0; morph_i < r_morphs.size(); morph_i++) {
+		arrays.push_back(r_morphs[morph_i]);
+	}
+
+	const float epsilon = 0.0001f;
+	for (int array_i = 0; array_i < arrays.size(); array_i++) {
+		const Array array = arrays[array_i];
+		if (array[Mesh::ARRAY_TEX_UV].get_type() != Variant::POOL_VECTOR2_ARRAY) {
+			continue;
+		}
+		const PoolVector2Array uvs = array[Mesh::ARRAY_TEX_UV];
+		PoolVector2Array::Read uvs_read = uvs.read();
+		for (int uv_i = 0; uv_i < uvs.size(); uv_i++) {
+			const Vector2 &uv = uvs_read[uv_i];
+			if (uv.x < -epsilon || uv.y < -epsilon || uv.x > 1.0f + epsilon || uv.y > 1.0f + epsilon) {
+				return false;
+			}
+		}
+	}
+
+	for (int array_i = 0; array_i < arrays.size(); array_i++) {
+		Array array = arrays[array_i];
+		if (array[Mesh::ARRAY_TEX_UV].get_type() != Variant::POOL_VECTOR2_ARRAY) {
+			continue;
+		}
+		PoolVector2Array array_uvs = array[Mesh::ARRAY_TEX_UV];
+		{
+			PoolVector2Array::Write uvs_write = array_uvs.write();
+			for (int uv_i = 0; uv_i < array_uvs.size(); uv_i++) {
+				const Vector2 uv = Vector2(CLAMP(uvs_write[uv_i].x, 0.0f, 1.0f), CLAMP(uvs_write[uv_i].y, 0.0f, 1.0f));
+				uvs_write[uv_i] = p_entry.uv_rect.position + uv * p_entry.uv_rect.size;
+			}
+		}
+		array[Mesh::ARRAY_TEX_UV] = array_uvs;
+	}
+	return true;
+}
+
 Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 	if (!state->json.has("meshes")) {
 		return OK;
 	}
 
+	int weld_vertices_before = 0;
+	int weld_vertices_after = 0;
+	int merge_surfaces_before = 0;
+	int merge_surfaces_after = 0;
+	int bounds_from_accessors = 0;
+	int bounds_invalid = 0;
+	int atlas_surfaces = 0;
+	int atlas_surfaces_skipped = 0;
+	int baked_transform_surfaces = 0;
+	state->vertex_color_materials.clear();
+	state->vertex_color_variants = 0;
+
 	Array meshes = state->json["meshes"];
 	for (GLTFMeshIndex i = 0; i < meshes.size(); i++) {
 		print_verbose("glTF: Parsing mesh: " + itos(i));
@@ -2808,6 +3375,9 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 		}
 		import_mesh->set_name(_gen_unique_name(state, str_format("{0}_{1}", state->scene_name, mesh_name)));
 
+		std::vector<SurfaceData> surfaces;
+		AABB mesh_aabb;
+		bool mesh_has_bounds = primitives.size() > 0;
 		for (int j = 0; j < primitives.size(); j++) {
 			Dictionary p = primitives[j];
 
@@ -2840,10 +3410,19 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 			}
 
 			ERR_FAIL_COND_V(!a.has("POSITION"), ERR_PARSE_ERROR);
+			AABB primitive_aabb;
+			bool primitive_has_bounds = false;
 			if (a.has("POSITION")) {
 				PoolVector3Array poolarray;
 				_decode_accessor_as_vec3(state, a["POSITION"], true, poolarray);
 				array[Mesh::ARRAY_VERTEX] = poolarray;
+
+				primitive_has_bounds = _get_accessor_bounds(state, a["POSITION"], primitive_aabb);
+				if (primitive_has_bounds && state->validate_accessor_bounds && !_vertices_within_bounds(poolarray, primitive_aabb)) {
+					WARN_PRINT(str_format("glTF: POSITION accessor {0} of mesh {1} has min/max bounds that do not contain its vertices.", a["POSITION"], i));
+					bounds_invalid++;
+					primitive_has_bounds = false;
+				}
 			}
 			if (a.has("NORMAL")) {
 				PoolVector3Array poolarray;
@@ -2871,36 +3450,27 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 				array[Mesh::ARRAY_COLOR] = poolarray;
 				has_vertex_color = true;
 			}
-			if (a.has("JOINTS_0") && !a.has("JOINTS_1")) {
-				PoolIntArray poolarray;
-				_decode_accessor_as_ints(state, a["JOINTS_0"], true, poolarray);
-				array[Mesh::ARRAY_BONES] = poolarray;
-			}
-			ERR_CONTINUE(a.has("JOINTS_0") && a.has("JOINTS_1"));
-			if (a.has("WEIGHTS_0") && !a.has("WEIGHTS_1")) {
-				PoolRealArray weights_arr;
-				_decode_accessor_as_floats(state, a["WEIGHTS_0"], true, weights_arr);
-				{ //gltf does not seem to normalize the weights for some reason..
-					int wc = weights_arr.size();
-					PoolRealArray::Write w = weights_arr.write();
-
-					for (int k = 0; k < wc; k += 4) {
-						float total = 0.0;
-						total += w[k + 0];
-						total += w[k + 1];
-						total += w[k + 2];
-						total += w[k + 3];
-						if (total > 0.0) {
-							w[k + 0] /= total;
-							w[k + 1] /= total;
-							w[k + 2] /= total;
-							w[k + 3] /= total;
-						}
-					}
+			if (a.has("JOINTS_0") && a.has("WEIGHTS_0")) {
+				// Gather every JOINTS_n/WEIGHTS_n set, Godot 3 only renders 4
+				// influences so the strongest ones are kept and renormalized.
+				// glTF does not seem to normalize the weights either.
+				std::vector<PoolIntArray> joint_sets;
+				std::vector<PoolRealArray> weight_sets;
+				for (int set_i = 0; a.has(String("JOINTS_") + itos(set_i)) && a.has(String("WEIGHTS_") + itos(set_i)); set_i++) {
+					PoolIntArray joints;
+					_decode_accessor_as_ints(state, a[String("JOINTS_") + itos(set_i)], true, joints);
+					PoolRealArray weights;
+					_decode_accessor_as_floats(state, a[String("WEIGHTS_") + itos(set_i)], true, weights);
+					joint_sets.push_back(joints);
+					weight_sets.push_back(weights);
+				}
+				PoolIntArray bones;
+				PoolRealArray weights;
+				if (_reduce_bone_influences(joint_sets, weight_sets, CLAMP(state->max_bone_influences, 1, 4), bones, weights)) {
+					array[Mesh::ARRAY_BONES] = bones;
+					array[Mesh::ARRAY_WEIGHTS] = weights;
 				}
-				array[Mesh::ARRAY_WEIGHTS] = weights_arr;
 			}
-			ERR_CONTINUE(a.has("WEIGHTS_0") && a.has("WEIGHTS_1"));
 
 			if (p.has("indices")) {
 				PoolIntArray indices;
@@ -2967,9 +3537,27 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 					}
 				}
 
+				// Targets blend together, so the extremes are the base bounds
+				// pushed out by every target's displacement range at once.
+				Vector3 delta_min;
+				Vector3 delta_max;
 				for (int k = 0; k < targets.size(); k++) {
 					const Dictionary &t = targets[k];
 
+					if (t.has("POSITION")) {
+						// Target accessors bound the displacements, not the positions.
+						AABB delta_aabb;
+						if (primitive_has_bounds && _get_accessor_bounds(state, t["POSITION"], delta_aabb)) {
+							const Vector3 end = delta_aabb.position + delta_aabb.size;
+							for (int axis = 0; axis < 3; axis++) {
+								delta_min[axis] += MIN(delta_aabb.position[axis], 0.0f);
+								delta_max[axis] += MAX(end[axis], 0.0f);
+							}
+						} else {
+							primitive_has_bounds = false;
+						}
+					}
+
 					Array array_copy;
 					array_copy.resize(Mesh::ARRAY_MAX);
 
@@ -3070,6 +3658,16 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 
 					morphs.push_back(array_copy);
 				}
+				if (primitive_has_bounds) {
+					primitive_aabb = AABB(primitive_aabb.position + delta_min, primitive_aabb.size + delta_max - delta_min);
+				}
+			}
+
+			if (state->weld_vertices && primitive == Mesh::PRIMITIVE_TRIANGLES && !p.has("indices")) {
+				// The generated indices above are trivial, so build real ones.
+				const int vertex_count = ((PoolVector3Array)array[Mesh::ARRAY_VERTEX]).size();
+				weld_vertices_before += vertex_count;
+				weld_vertices_after += _weld_surface_vertices(array, morphs, state->weld_epsilon);
 			}
 
 			//just add it
@@ -3079,20 +3677,58 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 				const int material = p["material"];
 				ERR_FAIL_INDEX_V(material, state->materials.size(), ERR_FILE_CORRUPT);
 				Ref<SpatialMaterial> mat3d = state->materials[material];
+				std::map<GLTFMaterialIndex, Transform2D>::const_iterator uv_transform = state->material_uv_transforms.find(material);
+				if (uv_transform != state->material_uv_transforms.end() && _bake_uv_transform(array, morphs, uv_transform->second)) {
+					baked_transform_surfaces++;
+				}
+				if (material < (int)state->material_atlas.size() && state->material_atlas[material].material.is_valid()) {
+					if (_remap_atlas_uvs(array, morphs, state->material_atlas[material])) {
+						mat3d = state->material_atlas[material].material;
+						atlas_surfaces++;
+					} else {
+						atlas_surfaces_skipped++;
+					}
+				}
 				if (has_vertex_color) {
-					mat3d->set_flag(SpatialMaterial::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+					mat3d = _get_vertex_color_material(state, mat3d);
 				}
 				mat = mat3d;
 
 			} else if (has_vertex_color) {
-				Ref<SpatialMaterial> mat3d;
-				mat3d.instance();
-				mat3d->set_flag(SpatialMaterial::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
-				mat = mat3d;
+				mat = _get_vertex_color_material(state, Ref<SpatialMaterial>());
+			}
+			if (!primitive_has_bounds) {
+				mesh_has_bounds = false;
+			} else if (j == 0) {
+				mesh_aabb = primitive_aabb;
+			} else {
+				mesh_aabb.merge_with(primitive_aabb);
 			}
+
+			SurfaceData surface;
+			surface.primitive = primitive;
+			surface.arrays = array;
+			surface.morphs = morphs;
+			surface.material = mat;
+			surfaces.push_back(surface);
+		}
+
+		if (state->merge_primitives) {
+			merge_surfaces_before += surfaces.size();
+			_merge_surfaces(surfaces);
+			merge_surfaces_after += surfaces.size();
+		}
+		for (size_t surface_i = 0; surface_i < surfaces.size(); surface_i++) {
+			const SurfaceData &surface = surfaces[surface_i];
 			int32_t mat_idx = import_mesh->get_surface_count();
-			import_mesh->add_surface_from_arrays(primitive, array, morphs);
-			import_mesh->surface_set_material(mat_idx, mat);
+			import_mesh->add_surface_from_arrays(surface.primitive, surface.arrays, surface.morphs);
+			import_mesh->surface_set_material(mat_idx, surface.material);
+		}
+		if (mesh_has_bounds) {
+			// Bounds straight from the accessors, including every morph target
+			// extreme, so culling never has to rely on the rest pose alone.
+			import_mesh->set_custom_aabb(mesh_aabb);
+			bounds_from_accessors++;
 		}
 
 		PoolRealArray blend_weights;
@@ -3120,89 +3756,1658 @@ Error GLTFDocument::_parse_meshes(Ref<GLTFState> state) {
 
 	print_verbose("glTF: Total meshes: " + itos(state->meshes.size()));
 
-	return OK;
-}
-
-Error GLTFDocument::_serialize_images(Ref<GLTFState> state, const String &p_path) {
-	Array images;
-	for (int i = 0; i < state->images.size(); i++) {
-		Dictionary d;
-
-		ERR_CONTINUE(state->images[i].is_null());
-
-		Ref<Image> image = state->images[i]->get_data();
-		ERR_CONTINUE(image.is_null());
-
-		String tmp_glb = "glb";
-		if (p_path.to_lower().ends_with(tmp_glb)) {
-			GLTFBufferViewIndex bvi;
-
-			Ref<GLTFBufferView> bv;
-			bv = GLTFBufferView_class->new_();
-
-			const GLTFBufferIndex bi = 0;
-			bv->buffer = bi;
-			bv->byte_offset = state->buffers[bi].size();
-			ERR_FAIL_INDEX_V(bi, state->buffers.size(), ERR_PARAMETER_RANGE_ERROR);
-
-			PoolByteArray buffer;
-			Ref<ImageTexture> img_tex = image;
-			if (img_tex.is_valid()) {
-				image = img_tex->get_data();
-			}
-			buffer = image->save_png_to_buffer();
-			ERR_FAIL_COND_V_MSG(buffer.size() == 0, ERR_INVALID_DATA, "Can't convert image to PNG.");
-
-			bv->byte_length = buffer.size();
-			state->buffers.write[bi].resize(state->buffers[bi].size() + bv->byte_length);
-			PoolByteArray::Write buffers_write = state->buffers.write[bi].write();
-			memcpy(&buffers_write.ptr()[bv->byte_offset], buffer.read().ptr(), buffer.size());
-			ERR_FAIL_COND_V(bv->byte_offset + bv->byte_length > state->buffers[bi].size(), ERR_FILE_CORRUPT);
-
-			state->buffer_views.push_back(bv);
-			bvi = state->buffer_views.size() - 1;
-			d["bufferView"] = bvi;
-			d["mimeType"] = "image/png";
-		} else {
-			String name = state->images[i]->get_name();
-			if (name.empty()) {
-				name = itos(i);
-			}
-			name = _gen_unique_name(state, name);
-			name = name.pad_zeros(3);
-			Ref<Directory> dir;
-			dir.instance();
-			String texture_dir = "textures";
-			String new_texture_dir = p_path.get_base_dir() + "/" + texture_dir;
-			dir->open(p_path.get_base_dir());
-			if (!dir->dir_exists(new_texture_dir)) {
-				dir->make_dir(new_texture_dir);
+	if (state->weld_vertices) {
+		Dictionary weld_stats;
+		weld_stats["vertices_before"] = weld_vertices_before;
+		weld_stats["vertices_after"] = weld_vertices_after;
+		state->import_stats["weld"] = weld_stats;
+		print_verbose(str_format("glTF: Welded {0} vertices into {1}", weld_vertices_before, weld_vertices_after));
+	}
+	Dictionary bounds_stats;
+	bounds_stats["meshes_from_accessors"] = bounds_from_accessors;
+	bounds_stats["invalid_accessors"] = bounds_invalid;
+	state->import_stats["bounds"] = bounds_stats;
+	{
+		// Vertex color variants are only known once the meshes are parsed.
+		std::set<const Object *> unique_materials;
+		for (int material_i = 0; material_i < state->materials.size(); material_i++) {
+			unique_materials.insert(state->materials[material_i].ptr());
+		}
+		for (int mesh_i = 0; mesh_i < state->meshes.size(); mesh_i++) {
+			Ref<ArrayMesh> mesh = state->meshes[mesh_i]->get_mesh();
+			for (int surface_i = 0; mesh.is_valid() && surface_i < mesh->get_surface_count(); surface_i++) {
+				Ref<Material> material = mesh->surface_get_material(surface_i);
+				if (material.is_valid()) {
+					unique_materials.insert(material.ptr());
+				}
 			}
-			name = name + ".png";
-			image->save_png(new_texture_dir.plus_file(name));
-			d["uri"] = texture_dir.plus_file(name);
 		}
-		images.push_back(d);
+		Dictionary material_stats = state->import_stats.has("materials") ? (Dictionary)state->import_stats["materials"] : Dictionary();
+		material_stats["unique"] = (int)unique_materials.size();
+		material_stats["vertex_color_variants"] = state->vertex_color_variants;
+		material_stats["baked_transform_surfaces"] = baked_transform_surfaces;
+		state->import_stats["materials"] = material_stats;
 	}
-
-	print_verbose("Total images: " + itos(state->images.size()));
-
-	if (!images.size()) {
-		return OK;
+	if (state->import_stats.has("atlas")) {
+		Dictionary atlas_stats = state->import_stats["atlas"];
+		atlas_stats["surfaces"] = atlas_surfaces;
+		atlas_stats["surfaces_skipped"] = atlas_surfaces_skipped;
+	}
+	if (state->merge_primitives) {
+		Dictionary merge_stats;
+		merge_stats["surfaces_before"] = merge_surfaces_before;
+		merge_stats["surfaces_after"] = merge_surfaces_after;
+		state->import_stats["merge"] = merge_stats;
+		print_verbose(str_format("glTF: Merged {0} primitives into {1} surfaces", merge_surfaces_before, merge_surfaces_after));
 	}
-	state->json["images"] = images;
 
 	return OK;
 }
 
-Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_path) {
-	if (!state->json.has("images")) {
-		return OK;
+// Copies a per-vertex pool array into r_floats, reporting how many components
+// each vertex has. Returns false for arrays that cannot be compared per vertex.
+static bool _vertex_array_to_floats(const Variant &p_source, int p_vertex_count, std::vector<float> &r_floats, int &r_components) {
+	r_components = 0;
+	switch (p_source.get_type()) {
+		case Variant::NIL: {
+			return true;
+		} break;
+		case Variant::POOL_VECTOR3_ARRAY: {
+			const PoolVector3Array src = p_source;
+			ERR_FAIL_COND_V(src.size() != p_vertex_count, false);
+			r_components = 3;
+			r_floats.resize(p_vertex_count * 3);
+			PoolVector3Array::Read r = src.read();
+			for (int i = 0; i < p_vertex_count; i++) {
+				r_floats[i * 3 + 0] = r[i].x;
+				r_floats[i * 3 + 1] = r[i].y;
+				r_floats[i * 3 + 2] = r[i].z;
+			}
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY: {
+			const PoolVector2Array src = p_source;
+			ERR_FAIL_COND_V(src.size() != p_vertex_count, false);
+			r_components = 2;
+			r_floats.resize(p_vertex_count * 2);
+			PoolVector2Array::Read r = src.read();
+			for (int i = 0; i < p_vertex_count; i++) {
+				r_floats[i * 2 + 0] = r[i].x;
+				r_floats[i * 2 + 1] = r[i].y;
+			}
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
+			const PoolColorArray src = p_source;
+			ERR_FAIL_COND_V(src.size() != p_vertex_count, false);
+			r_components = 4;
+			r_floats.resize(p_vertex_count * 4);
+			PoolColorArray::Read r = src.read();
+			for (int i = 0; i < p_vertex_count; i++) {
+				r_floats[i * 4 + 0] = r[i].r;
+				r_floats[i * 4 + 1] = r[i].g;
+				r_floats[i * 4 + 2] = r[i].b;
+				r_floats[i * 4 + 3] = r[i].a;
+			}
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+			const PoolRealArray src = p_source;
+			ERR_FAIL_COND_V(p_vertex_count == 0 || src.size() % p_vertex_count != 0, false);
+			r_components = src.size() / p_vertex_count;
+			r_floats.resize(src.size());
+			PoolRealArray::Read r = src.read();
+			for (int i = 0; i < src.size(); i++) {
+				r_floats[i] = r[i];
+			}
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+			const PoolIntArray src = p_source;
+			ERR_FAIL_COND_V(p_vertex_count == 0 || src.size() % p_vertex_count != 0, false);
+			r_components = src.size() / p_vertex_count;
+			r_floats.resize(src.size());
+			PoolIntArray::Read r = src.read();
+			for (int i = 0; i < src.size(); i++) {
+				r_floats[i] = r[i];
+			}
+		} break;
+		default: {
+			return false;
+		} break;
 	}
+	return true;
+}
 
-	// Ref: https://github.com/KhronosGroup/glTF/blob/master/specification/2.0/README.md#images
+int GLTFDocument::_weld_surface_vertices(Array &r_array, Array &r_morphs, float p_epsilon) {
+	const PoolVector3Array vertices = r_array[Mesh::ARRAY_VERTEX];
+	const PoolIntArray indices = r_array[Mesh::ARRAY_INDEX];
+	const int vertex_count = vertices.size();
+	if (vertex_count == 0 || indices.size() == 0) {
+		return vertex_count;
+	}
+	for (int morph_i = 0; morph_i < r_morphs.size(); morph_i++) {
+		// Morphs deindexed for tangent generation no longer line up.
+		const Array &morph = r_morphs[morph_i];
+		if (((PoolVector3Array)morph[Mesh::ARRAY_VERTEX]).size() != vertex_count) {
+			return vertex_count;
+		}
+	}
 
+	// Every attribute takes part in the key, including the morph target
+	// deltas: two vertices that only match in the base pose must stay apart.
+	std::vector<std::vector<float>> streams;
+	std::vector<int> stream_components;
+	int stride = 0;
+	auto add_stream = [&](const Variant &p_source) {
+		std::vector<float> floats;
+		int components = 0;
+		if (!_vertex_array_to_floats(p_source, vertex_count, floats, components)) {
+			return false;
+		}
+		if (components) {
+			streams.push_back(std::move(floats));
+			stream_components.push_back(components);
+			stride += components;
+		}
+		return true;
+	};
+	for (int array_i = 0; array_i < Mesh::ARRAY_MAX; array_i++) {
+		if (array_i != Mesh::ARRAY_INDEX && !add_stream(r_array[array_i])) {
+			return vertex_count;
+		}
+	}
+	for (int morph_i = 0; morph_i < r_morphs.size(); morph_i++) {
+		const Array &morph = r_morphs[morph_i];
+		if (!add_stream(morph[Mesh::ARRAY_VERTEX]) || !add_stream(morph[Mesh::ARRAY_NORMAL]) || !add_stream(morph[Mesh::ARRAY_TANGENT])) {
+			return vertex_count;
+		}
+	}
+
+	// With an epsilon, values are compared on a grid of that size; otherwise
+	// the exact bit patterns are used (with -0 folded into 0).
+	std::vector<int64_t> keys((size_t)vertex_count * stride);
+	int offset = 0;
+	for (size_t stream_i = 0; stream_i < streams.size(); stream_i++) {
+		const int components = stream_components[stream_i];
+		const std::vector<float> &stream = streams[stream_i];
+		for (int v = 0; v < vertex_count; v++) {
+			for (int c = 0; c < components; c++) {
+				float value = stream[v * components + c];
+				if (value == 0.0f) {
+					value = 0.0f;
+				}
+				int64_t key;
+				const double quantized = p_epsilon > 0.0f ? std::floor(value / p_epsilon + 0.5) : 0.0;
+				if (p_epsilon > 0.0f && std::fabs(quantized) < 9.0e18) {
+					key = (int64_t)quantized;
+				} else {
+					int32_t bits;
+					memcpy(&bits, &value, sizeof(bits));
+					key = bits;
+				}
+				keys[(size_t)v * stride + offset + c] = key;
+			}
+		}
+		offset += components;
+	}
+	streams.clear();
+
+	std::vector<int> order(vertex_count);
+	for (int i = 0; i < vertex_count; i++) {
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		const int64_t *ka = &keys[(size_t)a * stride];
+		const int64_t *kb = &keys[(size_t)b * stride];
+		for (int i = 0; i < stride; i++) {
+			if (ka[i] != kb[i]) {
+				return ka[i] < kb[i];
+			}
+		}
+		return a < b;
+	});
+
+	// Each group of equal vertices collapses onto its first occurrence, which
+	// keeps the original vertex order (and cache locality) for the survivors.
+	std::vector<int> remap(vertex_count);
+	for (int i = 0; i < vertex_count;) {
+		int j = i + 1;
+		while (j < vertex_count && std::equal(&keys[(size_t)order[i] * stride], &keys[(size_t)order[i] * stride] + stride, &keys[(size_t)order[j] * stride])) {
+			j++;
+		}
+		for (int k = i; k < j; k++) {
+			remap[order[k]] = order[i];
+		}
+		i = j;
+	}
+
+	std::vector<int> kept;
+	std::vector<int> new_index(vertex_count, -1);
+	for (int i = 0; i < vertex_count; i++) {
+		if (remap[i] == i) {
+			new_index[i] = kept.size();
+			kept.push_back(i);
+		}
+	}
+	if ((int)kept.size() == vertex_count) {
+		return vertex_count;
+	}
+
+	PoolIntArray welded_indices;
+	welded_indices.resize(indices.size());
+	{
+		PoolIntArray::Read r = indices.read();
+		PoolIntArray::Write w = welded_indices.write();
+		for (int i = 0; i < indices.size(); i++) {
+			ERR_FAIL_INDEX_V(r[i], vertex_count, vertex_count);
+			w[i] = new_index[remap[r[i]]];
+		}
+	}
+	r_array = _gather_surface_vertices(r_array, kept);
+	r_array[Mesh::ARRAY_INDEX] = welded_indices;
+	for (int morph_i = 0; morph_i < r_morphs.size(); morph_i++) {
+		r_morphs[morph_i] = _gather_surface_vertices(r_morphs[morph_i], kept);
+	}
+	return kept.size();
+}
+
+// Describes which attributes a surface carries and how wide they are, so
+// only surfaces that can share a vertex layout are merged.
+static Array _surface_layout(const Array &p_arrays) {
+	const int vertex_count = ((PoolVector3Array)p_arrays[Mesh::ARRAY_VERTEX]).size();
+	Array layout;
+	for (int array_i = 0; array_i < p_arrays.size(); array_i++) {
+		if (array_i == Mesh::ARRAY_INDEX) {
+			continue;
+		}
+		const Variant &source = p_arrays[array_i];
+		int components = 1;
+		if (vertex_count && source.get_type() == Variant::POOL_REAL_ARRAY) {
+			components = ((PoolRealArray)source).size() / vertex_count;
+		} else if (vertex_count && source.get_type() == Variant::POOL_INT_ARRAY) {
+			components = ((PoolIntArray)source).size() / vertex_count;
+		}
+		layout.push_back((int)source.get_type() * 16 + components);
+	}
+	return layout;
+}
+
+static bool _surface_layouts_match(const Array &p_a, const Array &p_b) {
+	if (p_a.empty() || p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.size(); i++) {
+		if ((int)p_a[i] != (int)p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void _append_vertex_array(Variant &r_dst, const Variant &p_src) {
+	switch (p_src.get_type()) {
+		case Variant::POOL_VECTOR3_ARRAY: {
+			PoolVector3Array dst = r_dst;
+			dst.append_array(p_src);
+			r_dst = dst;
+		} break;
+		case Variant::POOL_VECTOR2_ARRAY: {
+			PoolVector2Array dst = r_dst;
+			dst.append_array(p_src);
+			r_dst = dst;
+		} break;
+		case Variant::POOL_COLOR_ARRAY: {
+			PoolColorArray dst = r_dst;
+			dst.append_array(p_src);
+			r_dst = dst;
+		} break;
+		case Variant::POOL_REAL_ARRAY: {
+			PoolRealArray dst = r_dst;
+			dst.append_array(p_src);
+			r_dst = dst;
+		} break;
+		case Variant::POOL_INT_ARRAY: {
+			PoolIntArray dst = r_dst;
+			dst.append_array(p_src);
+			r_dst = dst;
+		} break;
+		default: {
+		} break;
+	}
+}
+
+void GLTFDocument::_merge_surfaces(std::vector<SurfaceData> &r_surfaces) {
+	std::vector<SurfaceData> merged;
+	std::vector<Array> merged_layouts;
+	std::vector<int> merged_vertex_counts;
+	for (size_t surface_i = 0; surface_i < r_surfaces.size(); surface_i++) {
+		SurfaceData &surface = r_surfaces[surface_i];
+		// Strips cannot be concatenated, and non-indexed points and lines
+		// would need index generation first.
+		const bool mergeable = (surface.primitive == Mesh::PRIMITIVE_TRIANGLES || surface.primitive == Mesh::PRIMITIVE_LINES || surface.primitive == Mesh::PRIMITIVE_POINTS) &&
+							   surface.arrays[Mesh::ARRAY_INDEX].get_type() == Variant::POOL_INT_ARRAY;
+		const Array layout = mergeable ? _surface_layout(surface.arrays) : Array();
+		const int vertex_count = ((PoolVector3Array)surface.arrays[Mesh::ARRAY_VERTEX]).size();
+
+		size_t target = merged.size();
+		if (mergeable) {
+			for (size_t merged_i = 0; merged_i < merged.size(); merged_i++) {
+				const SurfaceData &candidate = merged[merged_i];
+				if (candidate.material == surface.material && candidate.primitive == surface.primitive &&
+						candidate.morphs.size() == surface.morphs.size() && _surface_layouts_match(merged_layouts[merged_i], layout)) {
+					target = merged_i;
+					break;
+				}
+			}
+		}
+		if (target == merged.size()) {
+			merged.push_back(surface);
+			merged_layouts.push_back(layout);
+			merged_vertex_counts.push_back(vertex_count);
+			continue;
+		}
+
+		SurfaceData &destination = merged[target];
+		const int base_vertex = merged_vertex_counts[target];
+		PoolIntArray indices = surface.arrays[Mesh::ARRAY_INDEX];
+		{
+			const int index_count = indices.size();
+			PoolIntArray::Write w = indices.write();
+			for (int i = 0; i < index_count; i++) {
+				w[i] += base_vertex;
+			}
+		}
+		for (int array_i = 0; array_i < destination.arrays.size(); array_i++) {
+			if (array_i == Mesh::ARRAY_INDEX) {
+				_append_vertex_array(destination.arrays[array_i], indices);
+			} else {
+				_append_vertex_array(destination.arrays[array_i], surface.arrays[array_i]);
+			}
+		}
+		for (int morph_i = 0; morph_i < destination.morphs.size(); morph_i++) {
+			Array destination_morph = destination.morphs[morph_i];
+			const Array source_morph = surface.morphs[morph_i];
+			for (int array_i = 0; array_i < destination_morph.size(); array_i++) {
+				if (array_i != Mesh::ARRAY_INDEX) {
+					_append_vertex_array(destination_morph[array_i], source_morph[array_i]);
+				}
+			}
+		}
+		merged_vertex_counts[target] += vertex_count;
+	}
+	r_surfaces.swap(merged);
+}
+
+// Viewport LOD switch distances are derived for, in pixels and degrees.
+static const float LOD_REFERENCE_SCREEN_HEIGHT = 1080.0f;
+static const float LOD_REFERENCE_FOV = 70.0f;
+
+Array GLTFDocument::_gather_surface_vertices(const Array &p_arrays, const std::vector<int> &p_vertices) {
+	const PoolVector3Array source_vertices = p_arrays[Mesh::ARRAY_VERTEX];
+	const int source_count = source_vertices.size();
+	const int count = p_vertices.size();
+
+	Array arrays;
+	arrays.resize(p_arrays.size());
+	for (int array_i = 0; array_i < p_arrays.size(); array_i++) {
+		if (array_i == Mesh::ARRAY_INDEX) {
+			continue;
+		}
+		const Variant &source = p_arrays[array_i];
+		switch (source.get_type()) {
+			case Variant::POOL_VECTOR3_ARRAY: {
+				const PoolVector3Array src = source;
+				ERR_CONTINUE(src.size() != source_count);
+				PoolVector3Array dst;
+				dst.resize(count);
+				PoolVector3Array::Read r = src.read();
+				PoolVector3Array::Write w = dst.write();
+				for (int i = 0; i < count; i++) {
+					w[i] = r[p_vertices[i]];
+				}
+				arrays[array_i] = dst;
+			} break;
+			case Variant::POOL_VECTOR2_ARRAY: {
+				const PoolVector2Array src = source;
+				ERR_CONTINUE(src.size() != source_count);
+				PoolVector2Array dst;
+				dst.resize(count);
+				PoolVector2Array::Read r = src.read();
+				PoolVector2Array::Write w = dst.write();
+				for (int i = 0; i < count; i++) {
+					w[i] = r[p_vertices[i]];
+				}
+				arrays[array_i] = dst;
+			} break;
+			case Variant::POOL_COLOR_ARRAY: {
+				const PoolColorArray src = source;
+				ERR_CONTINUE(src.size() != source_count);
+				PoolColorArray dst;
+				dst.resize(count);
+				PoolColorArray::Read r = src.read();
+				PoolColorArray::Write w = dst.write();
+				for (int i = 0; i < count; i++) {
+					w[i] = r[p_vertices[i]];
+				}
+				arrays[array_i] = dst;
+			} break;
+			case Variant::POOL_REAL_ARRAY: {
+				// Tangents, bones and weights pack several components per vertex.
+				const PoolRealArray src = source;
+				ERR_CONTINUE(source_count == 0 || src.size() % source_count != 0);
+				const int stride = src.size() / source_count;
+				PoolRealArray dst;
+				dst.resize(count * stride);
+				PoolRealArray::Read r = src.read();
+				PoolRealArray::Write w = dst.write();
+				for (int i = 0; i < count; i++) {
+					for (int j = 0; j < stride; j++) {
+						w[i * stride + j] = r[p_vertices[i] * stride + j];
+					}
+				}
+				arrays[array_i] = dst;
+			} break;
+			case Variant::POOL_INT_ARRAY: {
+				const PoolIntArray src = source;
+				ERR_CONTINUE(source_count == 0 || src.size() % source_count != 0);
+				const int stride = src.size() / source_count;
+				PoolIntArray dst;
+				dst.resize(count * stride);
+				PoolIntArray::Read r = src.read();
+				PoolIntArray::Write w = dst.write();
+				for (int i = 0; i < count; i++) {
+					for (int j = 0; j < stride; j++) {
+						w[i * stride + j] = r[p_vertices[i] * stride + j];
+					}
+				}
+				arrays[array_i] = dst;
+			} break;
+			default: {
+			} break;
+		}
+	}
+	return arrays;
+}
+
+Error GLTFDocument::_generate_mesh_lods(Ref<GLTFState> state) {
+	// Everything the simplifier reads is copied out of the ArrayMeshes up
+	// front, so the worker threads never touch a Godot object.
+	struct LODSurface {
+		GLTFMeshIndex mesh = -1;
+		int surface = 0;
+		std::vector<float> positions;
+		std::vector<float> normals;
+		std::vector<float> uvs;
+		std::vector<float> weights;
+		std::vector<int> joint_groups;
+		std::vector<int> indices;
+		std::vector<std::vector<int>> levels;
+		std::vector<float> errors;
+	};
+
+	const int level_count = state->lod_ratios.size();
+	if (level_count == 0) {
+		return OK;
+	}
+	std::vector<float> ratios(level_count);
+	{
+		PoolRealArray::Read r = state->lod_ratios.read();
+		for (int i = 0; i < level_count; i++) {
+			ratios[i] = CLAMP(r[i], 0.0f, 1.0f);
+		}
+	}
+
+	std::vector<LODSurface> surfaces;
+	for (GLTFMeshIndex mesh_i = 0; mesh_i < state->meshes.size(); mesh_i++) {
+		Ref<ArrayMesh> import_mesh = state->meshes[mesh_i]->get_mesh();
+		if (import_mesh.is_null()) {
+			continue;
+		}
+		for (int surface_i = 0; surface_i < import_mesh->get_surface_count(); surface_i++) {
+			if (import_mesh->surface_get_primitive_type(surface_i) != Mesh::PRIMITIVE_TRIANGLES) {
+				continue;
+			}
+			const Array arrays = import_mesh->surface_get_arrays(surface_i);
+			const PoolIntArray indices = arrays[Mesh::ARRAY_INDEX];
+			const PoolVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+			if (indices.size() < 3 || vertices.size() == 0) {
+				continue;
+			}
+
+			LODSurface lod_surface;
+			lod_surface.mesh = mesh_i;
+			lod_surface.surface = surface_i;
+			lod_surface.positions.resize(vertices.size() * 3);
+			{
+				PoolVector3Array::Read r = vertices.read();
+				for (int i = 0; i < vertices.size(); i++) {
+					lod_surface.positions[i * 3 + 0] = r[i].x;
+					lod_surface.positions[i * 3 + 1] = r[i].y;
+					lod_surface.positions[i * 3 + 2] = r[i].z;
+				}
+			}
+			const PoolVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+			if (normals.size() == vertices.size()) {
+				lod_surface.normals.resize(normals.size() * 3);
+				PoolVector3Array::Read r = normals.read();
+				for (int i = 0; i < normals.size(); i++) {
+					lod_surface.normals[i * 3 + 0] = r[i].x;
+					lod_surface.normals[i * 3 + 1] = r[i].y;
+					lod_surface.normals[i * 3 + 2] = r[i].z;
+				}
+			}
+			const PoolVector2Array uvs = arrays[Mesh::ARRAY_TEX_UV];
+			if (uvs.size() == vertices.size()) {
+				lod_surface.uvs.resize(uvs.size() * 2);
+				PoolVector2Array::Read r = uvs.read();
+				for (int i = 0; i < uvs.size(); i++) {
+					lod_surface.uvs[i * 2 + 0] = r[i].x;
+					lod_surface.uvs[i * 2 + 1] = r[i].y;
+				}
+			}
+			// Vertices only collapse onto vertices with the same joints, the
+			// weights of those joints are sorted by joint to compare them.
+			const int INFLUENCES = 4;
+			if (arrays[Mesh::ARRAY_BONES].get_type() == Variant::POOL_INT_ARRAY &&
+					arrays[Mesh::ARRAY_WEIGHTS].get_type() == Variant::POOL_REAL_ARRAY) {
+				const PoolIntArray bones = arrays[Mesh::ARRAY_BONES];
+				const PoolRealArray weights = arrays[Mesh::ARRAY_WEIGHTS];
+				if (bones.size() == vertices.size() * INFLUENCES && weights.size() == vertices.size() * INFLUENCES) {
+					PoolIntArray::Read bone_read = bones.read();
+					PoolRealArray::Read weight_read = weights.read();
+					std::map<std::vector<int>, int> group_ids;
+					lod_surface.weights.resize(weights.size());
+					lod_surface.joint_groups.resize(vertices.size());
+					for (int i = 0; i < vertices.size(); i++) {
+						std::vector<std::pair<int, float>> influences;
+						for (int k = 0; k < INFLUENCES; k++) {
+							if (weight_read[i * INFLUENCES + k] > 0.0f) {
+								influences.push_back(std::make_pair(bone_read[i * INFLUENCES + k], weight_read[i * INFLUENCES + k]));
+							}
+						}
+						std::sort(influences.begin(), influences.end());
+						std::vector<int> joints;
+						for (int k = 0; k < INFLUENCES; k++) {
+							lod_surface.weights[i * INFLUENCES + k] = k < (int)influences.size() ? influences[k].second : 0.0f;
+							if (k < (int)influences.size()) {
+								joints.push_back(influences[k].first);
+							}
+						}
+						lod_surface.joint_groups[i] = group_ids.insert(std::make_pair(joints, (int)group_ids.size())).first->second;
+					}
+				}
+			}
+			lod_surface.indices.resize(indices.size());
+			{
+				PoolIntArray::Read r = indices.read();
+				for (int i = 0; i < indices.size(); i++) {
+					lod_surface.indices[i] = r[i];
+				}
+			}
+			surfaces.push_back(std::move(lod_surface));
+		}
+	}
+
+	const float target_error = state->lod_target_error;
+	ThreadWorkPool::do_work(surfaces.size(), state->worker_thread_count, [&](int p_index) {
+		LODSurface &lod_surface = surfaces[p_index];
+		std::vector<MeshSimplifier::Attribute> attributes;
+		if (!lod_surface.normals.empty()) {
+			attributes.push_back({ lod_surface.normals.data(), 3, 0.01f });
+		}
+		if (!lod_surface.uvs.empty()) {
+			attributes.push_back({ lod_surface.uvs.data(), 2, 0.01f });
+		}
+		if (!lod_surface.weights.empty()) {
+			attributes.push_back({ lod_surface.weights.data(), 4, 0.01f });
+		}
+		// Each level starts from the previous one, which keeps the chain
+		// nested and makes the later levels much cheaper to compute.
+		const std::vector<int> *source = &lod_surface.indices;
+		lod_surface.levels.resize(ratios.size());
+		lod_surface.errors.resize(ratios.size(), 0.0f);
+		for (size_t level_i = 0; level_i < ratios.size(); level_i++) {
+			const int target = int(lod_surface.indices.size() / 3 * ratios[level_i]) * 3;
+			const float error = MeshSimplifier::simplify(lod_surface.positions.data(), lod_surface.positions.size() / 3,
+					*source, target, target_error, attributes, lod_surface.joint_groups, lod_surface.levels[level_i]);
+			lod_surface.errors[level_i] = std::max(error, level_i > 0 ? lod_surface.errors[level_i - 1] : 0.0f);
+			source = &lod_surface.levels[level_i];
+		}
+	});
+
+	const float pixel_error = MAX(state->lod_pixel_error, CMP_EPSILON);
+
+	Array stats;
+	size_t surface_cursor = 0;
+	for (GLTFMeshIndex mesh_i = 0; mesh_i < state->meshes.size(); mesh_i++) {
+		Ref<GLTFMesh> gltf_mesh = state->meshes[mesh_i];
+		Ref<ArrayMesh> import_mesh = gltf_mesh->get_mesh();
+		size_t surface_begin = surface_cursor;
+		while (surface_cursor < surfaces.size() && surfaces[surface_cursor].mesh == mesh_i) {
+			surface_cursor++;
+		}
+		if (surface_begin == surface_cursor) {
+			continue;
+		}
+
+		int source_triangles = 0;
+		for (size_t i = surface_begin; i < surface_cursor; i++) {
+			source_triangles += surfaces[i].indices.size() / 3;
+		}
+		PoolIntArray level_triangles;
+		PoolRealArray level_errors;
+		level_triangles.push_back(source_triangles);
+		level_errors.push_back(0.0f);
+
+		Array lods;
+		PoolRealArray lod_distances;
+		int previous_triangles = source_triangles;
+		for (int level_i = 0; level_i < level_count; level_i++) {
+			int triangles = 0;
+			float error = 0.0f;
+			for (size_t i = surface_begin; i < surface_cursor; i++) {
+				triangles += surfaces[i].levels[level_i].size() / 3;
+				error = MAX(error, surfaces[i].errors[level_i]);
+			}
+			// A level that barely removes anything is not worth a swap.
+			if (triangles == 0 || triangles > previous_triangles * 0.9f) {
+				continue;
+			}
+			previous_triangles = triangles;
+
+			Ref<ArrayMesh> lod_mesh;
+			lod_mesh.instance();
+			lod_mesh->set_name(import_mesh->get_name() + "_LOD" + itos(lods.size() + 1));
+			lod_mesh->set_blend_shape_mode(import_mesh->get_blend_shape_mode());
+			for (int blend_i = 0; blend_i < import_mesh->get_blend_shape_count(); blend_i++) {
+				lod_mesh->add_blend_shape(import_mesh->get_blend_shape_name(blend_i));
+			}
+			size_t lod_surface_i = surface_begin;
+			for (int surface_i = 0; surface_i < import_mesh->get_surface_count(); surface_i++) {
+				const Array arrays = import_mesh->surface_get_arrays(surface_i);
+				const Array morphs = import_mesh->surface_get_blend_shape_arrays(surface_i);
+				Array lod_arrays = arrays;
+				Array lod_morphs = morphs;
+				if (lod_surface_i < surface_cursor && surfaces[lod_surface_i].surface == surface_i) {
+					// Compact the vertices, the simplifier leaves unused ones behind.
+					const std::vector<int> &level = surfaces[lod_surface_i].levels[level_i];
+					std::vector<int> remap(surfaces[lod_surface_i].positions.size() / 3, -1);
+					std::vector<int> vertices;
+					PoolIntArray lod_indices;
+					lod_indices.resize(level.size());
+					{
+						PoolIntArray::Write w = lod_indices.write();
+						for (size_t i = 0; i < level.size(); i++) {
+							if (remap[level[i]] < 0) {
+								remap[level[i]] = vertices.size();
+								vertices.push_back(level[i]);
+							}
+							w[i] = remap[level[i]];
+						}
+					}
+					lod_arrays = _gather_surface_vertices(arrays, vertices);
+					lod_arrays[Mesh::ARRAY_INDEX] = lod_indices;
+					lod_morphs = Array();
+					for (int morph_i = 0; morph_i < morphs.size(); morph_i++) {
+						lod_morphs.push_back(_gather_surface_vertices(morphs[morph_i], vertices));
+					}
+					lod_surface_i++;
+				}
+				lod_mesh->add_surface_from_arrays(import_mesh->surface_get_primitive_type(surface_i), lod_arrays, lod_morphs);
+				lod_mesh->surface_set_material(surface_i, import_mesh->surface_get_material(surface_i));
+			}
+
+			// Switch once the error would span lod_pixel_error pixels.
+			float distance = error * LOD_REFERENCE_SCREEN_HEIGHT / (2.0f * Math::tan(Math::deg2rad(LOD_REFERENCE_FOV) * 0.5f) * pixel_error);
+			if (lod_distances.size()) {
+				distance = MAX(distance, lod_distances[lod_distances.size() - 1]);
+			}
+			lods.push_back(lod_mesh);
+			lod_distances.push_back(distance);
+			level_triangles.push_back(triangles);
+			level_errors.push_back(error);
+		}
+		gltf_mesh->set_lods(lods);
+		gltf_mesh->set_lod_distances(lod_distances);
+
+		Dictionary mesh_stats;
+		mesh_stats["mesh"] = mesh_i;
+		mesh_stats["triangles"] = level_triangles;
+		mesh_stats["errors"] = level_errors;
+		stats.push_back(mesh_stats);
+		print_verbose(str_format("glTF: Mesh {0} generated {1} LOD levels", mesh_i, lods.size()));
+	}
+	state->import_stats["lods"] = stats;
+
+	return OK;
+}
+
+Error GLTFDocument::_split_mesh_chunks(Ref<GLTFState> state) {
+	struct ChunkTriangle {
+		int surface;
+		int index;
+		Vector3 centroid;
+	};
+
+	const int max_triangles = MAX(state->chunk_max_triangles, 1);
+	const real_t max_size = state->chunk_max_size;
+	Array stats;
+
+	for (GLTFMeshIndex mesh_i = 0; mesh_i < state->meshes.size(); mesh_i++) {
+		Ref<GLTFMesh> gltf_mesh = state->meshes[mesh_i];
+		Ref<ArrayMesh> import_mesh = gltf_mesh->get_mesh();
+		if (import_mesh.is_null() || import_mesh->get_blend_shape_count()) {
+			continue;
+		}
+
+		std::vector<Array> surface_arrays;
+		std::vector<PoolIntArray> surface_indices;
+		std::vector<PoolVector3Array> surface_vertices;
+		bool splittable = true;
+		int triangle_count = 0;
+		for (int surface_i = 0; surface_i < import_mesh->get_surface_count() && splittable; surface_i++) {
+			const Array arrays = import_mesh->surface_get_arrays(surface_i);
+			splittable = import_mesh->surface_get_primitive_type(surface_i) == Mesh::PRIMITIVE_TRIANGLES && arrays[Mesh::ARRAY_INDEX].get_type() == Variant::POOL_INT_ARRAY;
+			if (splittable) {
+				surface_arrays.push_back(arrays);
+				surface_indices.push_back(arrays[Mesh::ARRAY_INDEX]);
+				surface_vertices.push_back(arrays[Mesh::ARRAY_VERTEX]);
+				triangle_count += surface_indices.back().size() / 3;
+			}
+		}
+		const AABB mesh_aabb = import_mesh->get_aabb();
+		if (!splittable || (triangle_count <= max_triangles && (max_size <= 0.0f || mesh_aabb.get_longest_axis_size() <= max_size))) {
+			continue;
+		}
+
+		std::vector<ChunkTriangle> triangles;
+		triangles.reserve(triangle_count);
+		for (size_t surface_i = 0; surface_i < surface_indices.size(); surface_i++) {
+			PoolIntArray::Read indices = surface_indices[surface_i].read();
+			PoolVector3Array::Read vertices = surface_vertices[surface_i].read();
+			const int vertex_count = surface_vertices[surface_i].size();
+			for (int tri_i = 0; tri_i < surface_indices[surface_i].size() / 3; tri_i++) {
+				const int i0 = indices[tri_i * 3 + 0];
+				const int i1 = indices[tri_i * 3 + 1];
+				const int i2 = indices[tri_i * 3 + 2];
+				ERR_CONTINUE(i0 >= vertex_count || i1 >= vertex_count || i2 >= vertex_count);
+				triangles.push_back({ (int)surface_i, tri_i, (vertices[i0] + vertices[i1] + vertices[i2]) / 3.0f });
+			}
+		}
+
+		// Median splits along the longest axis until every chunk is small
+		// enough in both triangle count and extent; the leaves come out in
+		// spatial order, which also keeps neighbouring chunks adjacent.
+		std::vector<std::pair<int, int>> ranges;
+		std::vector<std::pair<int, int>> stack;
+		stack.push_back(std::make_pair(0, (int)triangles.size()));
+		while (!stack.empty()) {
+			const std::pair<int, int> range = stack.back();
+			stack.pop_back();
+			AABB bounds(triangles[range.first].centroid, Vector3());
+			for (int i = range.first + 1; i < range.second; i++) {
+				bounds.expand_to(triangles[i].centroid);
+			}
+			const int count = range.second - range.first;
+			const bool too_large = max_size > 0.0f && bounds.get_longest_axis_size() > max_size;
+			if (count <= 1 || (count <= max_triangles && !too_large)) {
+				ranges.push_back(range);
+				continue;
+			}
+			const int axis = bounds.get_longest_axis_index();
+			const int middle = range.first + count / 2;
+			std::nth_element(triangles.begin() + range.first, triangles.begin() + middle, triangles.begin() + range.second, [axis](const ChunkTriangle &p_a, const ChunkTriangle &p_b) {
+				return p_a.centroid[axis] < p_b.centroid[axis];
+			});
+			stack.push_back(std::make_pair(middle, range.second));
+			stack.push_back(std::make_pair(range.first, middle));
+		}
+
+		std::vector<PoolIntArray::Read> index_reads;
+		index_reads.reserve(surface_indices.size());
+		for (size_t surface_i = 0; surface_i < surface_indices.size(); surface_i++) {
+			index_reads.push_back(surface_indices[surface_i].read());
+		}
+
+		// Per surface map from source to chunk vertex, allocated once and
+		// reset after each chunk through the chunk's vertex list.
+		std::vector<std::vector<int>> remaps(surface_arrays.size());
+		for (size_t surface_i = 0; surface_i < surface_arrays.size(); surface_i++) {
+			remaps[surface_i].assign(surface_vertices[surface_i].size(), -1);
+		}
+
+		Array chunks;
+		PoolIntArray chunk_triangles;
+		for (size_t range_i = 0; range_i < ranges.size(); range_i++) {
+			std::vector<std::vector<int>> chunk_indices(surface_arrays.size());
+			for (int i = ranges[range_i].first; i < ranges[range_i].second; i++) {
+				const int *indices = index_reads[triangles[i].surface].ptr() + triangles[i].index * 3;
+				std::vector<int> &dst = chunk_indices[triangles[i].surface];
+				dst.push_back(indices[0]);
+				dst.push_back(indices[1]);
+				dst.push_back(indices[2]);
+			}
+
+			Ref<ArrayMesh> chunk_mesh;
+			chunk_mesh.instance();
+			chunk_mesh->set_name(import_mesh->get_name() + "_chunk" + itos(range_i));
+			for (size_t surface_i = 0; surface_i < surface_arrays.size(); surface_i++) {
+				const std::vector<int> &level = chunk_indices[surface_i];
+				if (level.empty()) {
+					continue;
+				}
+				// Boundary vertices are copied into every chunk using them, with
+				// identical attributes, so the chunks meet without cracks.
+				std::vector<int> &remap = remaps[surface_i];
+				std::vector<int> vertices;
+				PoolIntArray indices;
+				indices.resize(level.size());
+				{
+					PoolIntArray::Write w = indices.write();
+					for (size_t i = 0; i < level.size(); i++) {
+						if (remap[level[i]] < 0) {
+							remap[level[i]] = vertices.size();
+							vertices.push_back(level[i]);
+						}
+						w[i] = remap[level[i]];
+					}
+				}
+				for (size_t i = 0; i < vertices.size(); i++) {
+					remap[vertices[i]] = -1;
+				}
+				Array arrays = _gather_surface_vertices(surface_arrays[surface_i], vertices);
+				arrays[Mesh::ARRAY_INDEX] = indices;
+				const int chunk_surface_i = chunk_mesh->get_surface_count();
+				chunk_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+				chunk_mesh->surface_set_material(chunk_surface_i, import_mesh->surface_get_material(surface_i));
+			}
+			chunks.push_back(chunk_mesh);
+			chunk_triangles.push_back(ranges[range_i].second - ranges[range_i].first);
+		}
+		gltf_mesh->set_chunks(chunks);
+
+		Dictionary mesh_stats;
+		mesh_stats["mesh"] = mesh_i;
+		mesh_stats["triangles"] = chunk_triangles;
+		stats.push_back(mesh_stats);
+		print_verbose(str_format("glTF: Split mesh {0} into {1} chunks", mesh_i, chunks.size()));
+	}
+	state->import_stats["chunks"] = stats;
+
+	return OK;
+}
+
+Ref<Image> GLTFDocument::_bleed_image_alpha(Ref<Image> p_image, int p_threads) {
+	if (p_image->is_compressed() || p_image->detect_alpha() == Image::ALPHA_NONE) {
+		return p_image;
+	}
+	Ref<Image> image = p_image->duplicate();
+	image->clear_mipmaps();
+	image->convert(Image::FORMAT_RGBA8);
+	PoolByteArray data = image->get_data();
+	bool bled = false;
+	{
+		PoolByteArray::Write w = data.write();
+		bled = gltf_texture_bleed(w.ptr(), image->get_width(), image->get_height(), p_threads);
+	}
+	if (!bled) {
+		return p_image;
+	}
+	image->create_from_data(image->get_width(), image->get_height(), false, Image::FORMAT_RGBA8, data);
+	return image;
+}
+
+void GLTFDocument::_generate_image_mipmaps(Ref<Image> p_image, bool p_srgb, int p_threads) {
+	if (p_image->is_compressed() || p_image->has_mipmaps()) {
+		return;
+	}
+	int channels = 0;
+	switch (p_image->get_format()) {
+		case Image::FORMAT_L8:
+			channels = 1;
+			break;
+		case Image::FORMAT_LA8:
+			channels = 2;
+			break;
+		case Image::FORMAT_RGB8:
+			channels = 3;
+			break;
+		case Image::FORMAT_RGBA8:
+			channels = 4;
+			break;
+		default:
+			p_image->generate_mipmaps();
+			return;
+	}
+	const int width = p_image->get_width();
+	const int height = p_image->get_height();
+	const PoolByteArray level_data = p_image->get_data();
+	PoolByteArray data;
+	data.resize(gltf_mipmap_chain_size(width, height, channels));
+	{
+		PoolByteArray::Read level_read = level_data.read();
+		PoolByteArray::Write data_write = data.write();
+		memcpy(data_write.ptr(), level_read.ptr(), level_data.size());
+		gltf_generate_mipmaps(data_write.ptr(), width, height, channels, p_srgb, p_threads);
+	}
+	p_image->create_from_data(width, height, true, p_image->get_format(), data);
+}
+
+// The engine decoders only take a whole PoolByteArray. Base64 data, external
+// files and buffers holding a single image are passed as they are, only PNG,
+// JPEG and WebP slices of a larger buffer, such as the GLB BIN chunk, need
+// their own copy.
+static PoolByteArray _get_image_source_bytes(const GLTFImageSource &p_source) {
+	if (p_source.offset == 0 && p_source.size == p_source.data.size()) {
+		return p_source.data;
+	}
+	PoolByteArray bytes;
+	bytes.resize(p_source.size);
+	PoolByteArray::Read data_read = p_source.data.read();
+	PoolByteArray::Write bytes_write = bytes.write();
+	memcpy(bytes_write.ptr(), data_read.ptr() + p_source.offset, p_source.size);
+	return bytes;
+}
+
+// Identifies an image's pixels, to tell whether a texture still matches the
+// file it was imported from.
+static uint64_t _hash_image_pixels(Ref<Image> p_image) {
+	const PoolByteArray data = p_image->get_data();
+	PoolByteArray::Read data_read = data.read();
+	uint64_t hash = gltf_hash_bytes(data_read.ptr(), data.size());
+	hash = gltf_hash_int(p_image->get_width(), hash);
+	hash = gltf_hash_int(p_image->get_height(), hash);
+	hash = gltf_hash_int(p_image->get_format(), hash);
+	return hash;
+}
+
+Error GLTFDocument::_serialize_images(Ref<GLTFState> state, const String &p_path) {
+	// Image data is fetched on the calling thread, PNG encoding (and alpha
+	// bleeding) runs on the workers. Identical images are encoded once and
+	// share their buffer view or file, and encoded PNGs are kept in the
+	// process-wide registry for later exports.
+	struct ExportImage {
+		Ref<Image> image;
+		uint64_t key = 0;
+		int same_as = -1;
+		PoolByteArray png;
+		String mime_type = "image/png";
+		Dictionary json;
+		// Original file bytes recorded at import, see keep_source_images.
+		PoolByteArray source_data;
+		String source_mime_type;
+		uint64_t source_pixel_hash = 0;
+	};
+	std::vector<ExportImage> export_images(state->images.size());
+	std::map<const Object *, int> texture_images;
+	for (int i = 0; i < state->images.size(); i++) {
+		ERR_CONTINUE(state->images[i].is_null());
+		std::map<const Object *, int>::iterator it = texture_images.find(state->images[i].ptr());
+		if (it != texture_images.end()) {
+			export_images[i].same_as = it->second;
+			continue;
+		}
+		texture_images[state->images[i].ptr()] = i;
+
+		Ref<Image> image = state->images[i]->get_data();
+		ERR_CONTINUE(image.is_null());
+		export_images[i].image = image;
+		if (state->images[i]->has_meta("gltf_source_data")) {
+			export_images[i].source_data = state->images[i]->get_meta("gltf_source_data");
+			export_images[i].source_mime_type = state->images[i]->get_meta("gltf_source_mime_type");
+			export_images[i].source_pixel_hash = (int64_t)state->images[i]->get_meta("gltf_source_pixel_hash");
+		}
+	}
+
+	ThreadWorkPool::do_work(export_images.size(), state->worker_thread_count, [&](int p_index) {
+		ExportImage &export_image = export_images[p_index];
+		if (export_image.image.is_null()) {
+			return;
+		}
+		const uint64_t pixel_hash = _hash_image_pixels(export_image.image);
+		export_image.key = gltf_hash_int(state->bleed_texture_alpha, pixel_hash);
+		// Unchanged since import, the original file is written as is. Images
+		// with alpha still need their colors bled when that is enabled.
+		const bool needs_bleed = state->bleed_texture_alpha && !export_image.image->is_compressed() && export_image.image->detect_alpha() != Image::ALPHA_NONE;
+		if (export_image.source_data.size() && pixel_hash == export_image.source_pixel_hash && !needs_bleed) {
+			export_image.png = export_image.source_data;
+			export_image.mime_type = export_image.source_mime_type;
+		}
+		export_image.source_data = PoolByteArray();
+	});
+
+	std::map<uint64_t, int> key_images;
+	std::vector<int> to_encode;
+	for (size_t i = 0; i < export_images.size(); i++) {
+		ExportImage &export_image = export_images[i];
+		if (export_image.image.is_null()) {
+			continue;
+		}
+		std::map<uint64_t, int>::iterator it = key_images.find(export_image.key);
+		if (it != key_images.end()) {
+			export_image.same_as = it->second;
+			export_image.image = Ref<Image>();
+			continue;
+		}
+		key_images[export_image.key] = i;
+		if (export_image.png.size() == 0) {
+			export_image.png = GLTFResourceRegistry::find_data("png", export_image.key);
+		}
+		if (export_image.png.size() == 0) {
+			to_encode.push_back(i);
+		}
+	}
+
+	// A single image bleeds on the workers itself, several are spread over
+	// them one image each.
+	const int bleed_threads = to_encode.size() > 1 ? 1 : state->worker_thread_count;
+	ThreadWorkPool::do_work(to_encode.size(), state->worker_thread_count, [&](int p_index) {
+		ExportImage &export_image = export_images[to_encode[p_index]];
+		Ref<Image> image = export_image.image;
+		if (state->bleed_texture_alpha) {
+			image = _bleed_image_alpha(image, bleed_threads);
+		}
+		export_image.png = image->save_png_to_buffer();
+	});
+
+	String tmp_glb = "glb";
+	const bool is_glb = p_path.to_lower().ends_with(tmp_glb);
+	Array images;
+	for (int i = 0; i < (int)export_images.size(); i++) {
+		ExportImage &export_image = export_images[i];
+		if (export_image.same_as >= 0) {
+			export_image.json = export_images[export_image.same_as].json;
+			ERR_CONTINUE(export_image.json.empty());
+			images.push_back(export_image.json);
+			continue;
+		}
+		if (export_image.image.is_null()) {
+			continue;
+		}
+		const PoolByteArray &buffer = export_image.png;
+		ERR_FAIL_COND_V_MSG(buffer.size() == 0, ERR_INVALID_DATA, "Can't convert image to PNG.");
+		if (export_image.mime_type == "image/png") {
+			GLTFResourceRegistry::add_data(export_image.key, buffer);
+		}
+
+		Dictionary d;
+		if (is_glb) {
+			GLTFBufferViewIndex bvi;
+
+			Ref<GLTFBufferView> bv;
+			bv = GLTFBufferView_class->new_();
+
+			const GLTFBufferIndex bi = 0;
+			bv->buffer = bi;
+			bv->byte_offset = state->buffers[bi].size();
+			ERR_FAIL_INDEX_V(bi, state->buffers.size(), ERR_PARAMETER_RANGE_ERROR);
+
+			bv->byte_length = buffer.size();
+			state->buffers.write[bi].resize(state->buffers[bi].size() + bv->byte_length);
+			PoolByteArray::Write buffers_write = state->buffers.write[bi].write();
+			memcpy(&buffers_write.ptr()[bv->byte_offset], buffer.read().ptr(), buffer.size());
+			ERR_FAIL_COND_V(bv->byte_offset + bv->byte_length > state->buffers[bi].size(), ERR_FILE_CORRUPT);
+
+			state->buffer_views.push_back(bv);
+			bvi = state->buffer_views.size() - 1;
+			d["bufferView"] = bvi;
+			d["mimeType"] = export_image.mime_type;
+		} else {
+			String name = state->images[i]->get_name();
+			if (name.empty()) {
+				name = itos(i);
+			}
+			name = _gen_unique_name(state, name);
+			name = name.pad_zeros(3);
+			Ref<Directory> dir;
+			dir.instance();
+			String texture_dir = "textures";
+			String new_texture_dir = p_path.get_base_dir() + "/" + texture_dir;
+			dir->open(p_path.get_base_dir());
+			if (!dir->dir_exists(new_texture_dir)) {
+				dir->make_dir(new_texture_dir);
+			}
+			name = name + (export_image.mime_type == "image/jpeg" ? ".jpg" : ".png");
+			Ref<File> f;
+			f.instance();
+			if (f->open(new_texture_dir.plus_file(name), File::WRITE) == OK) {
+				f->store_buffer(buffer);
+				f->close();
+			}
+			d["uri"] = texture_dir.plus_file(name);
+		}
+		export_image.json = d;
+		images.push_back(d);
+	}
+
+	print_verbose("Total images: " + itos(state->images.size()));
+
+	if (!images.size()) {
+		return OK;
+	}
+	state->json["images"] = images;
+
+	return OK;
+}
+
+// Images compressed at import time are cached on disk as the raw Image data,
+// keyed by the encoded source bytes and the compression settings. The file
+// layout lives in gltf_texture_cache.h.
+static String _get_texture_cache_file(const String &p_cache_path, uint64_t p_key) {
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.gltfimg", (unsigned long long)p_key);
+	return p_cache_path.plus_file(name);
+}
+
+static Ref<Image> _load_cached_image(const String &p_file) {
+	Ref<File> f;
+	f.instance();
+	if (!f->file_exists(p_file) || f->open(p_file, File::READ) != OK) {
+		return Ref<Image>();
+	}
+	const PoolByteArray file_data = f->get_buffer(f->get_len());
+	f->close();
+
+	GLTFTextureCacheEntry entry;
+	PoolByteArray::Read r = file_data.read();
+	ERR_FAIL_COND_V_MSG(!gltf_texture_cache_read(r.ptr(), file_data.size(), entry) || entry.format >= (uint32_t)Image::FORMAT_MAX, Ref<Image>(),
+			"glTF: Ignoring corrupt texture cache file: " + p_file);
+	PoolByteArray data;
+	data.resize(entry.data_size);
+	memcpy(data.write().ptr(), entry.data, entry.data_size);
+
+	Ref<Image> image;
+	image.instance();
+	image->create_from_data(entry.width, entry.height, entry.mipmaps, entry.format, data);
+	if (image->is_empty()) {
+		return Ref<Image>();
+	}
+	return image;
+}
+
+static void _store_cached_image(const String &p_file, Ref<Image> p_image) {
+	// Written under a temporary name so that concurrent imports never read
+	// a partial file.
+	static std::atomic<uint32_t> tmp_counter(0);
+	const String tmp_file = p_file + ".tmp" + itos(tmp_counter.fetch_add(1));
+	Ref<File> f;
+	f.instance();
+	ERR_FAIL_COND_MSG(f->open(tmp_file, File::WRITE) != OK, "glTF: Can't write texture cache file: " + tmp_file);
+	const PoolByteArray data = p_image->get_data();
+	PoolByteArray header;
+	header.resize(GLTF_TEXTURE_CACHE_HEADER_SIZE);
+	{
+		PoolByteArray::Read r = data.read();
+		GLTFTextureCacheEntry entry;
+		entry.width = p_image->get_width();
+		entry.height = p_image->get_height();
+		entry.mipmaps = p_image->has_mipmaps();
+		entry.format = p_image->get_format();
+		entry.data = r.ptr();
+		entry.data_size = data.size();
+		gltf_texture_cache_write_header(entry, header.write().ptr());
+	}
+	f->store_buffer(header);
+	f->store_buffer(data);
+	f->close();
+
+	Ref<Directory> dir;
+	dir.instance();
+	if (dir->rename(tmp_file, p_file) != OK) {
+		dir->remove(tmp_file);
+	}
+}
+
+static const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+// Maps the VkFormat of a KTX2 container onto the Image format Godot uploads
+// as is, or -1 when there is no direct equivalent.
+static int _ktx2_vk_format_to_image_format(uint32_t p_vk_format) {
+	switch (p_vk_format) {
+		case 23: // VK_FORMAT_R8G8B8_UNORM
+		case 29: // VK_FORMAT_R8G8B8_SRGB
+			return Image::FORMAT_RGB8;
+		case 37: // VK_FORMAT_R8G8B8A8_UNORM
+		case 43: // VK_FORMAT_R8G8B8A8_SRGB
+			return Image::FORMAT_RGBA8;
+		case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+		case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+		case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+		case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+			return Image::FORMAT_DXT1;
+		case 135: // VK_FORMAT_BC2_UNORM_BLOCK
+		case 136: // VK_FORMAT_BC2_SRGB_BLOCK
+			return Image::FORMAT_DXT3;
+		case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+		case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+			return Image::FORMAT_DXT5;
+		case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+			return Image::FORMAT_RGTC_R;
+		case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+			return Image::FORMAT_RGTC_RG;
+		case 143: // VK_FORMAT_BC6H_UFLOAT_BLOCK
+			return Image::FORMAT_BPTC_RGBFU;
+		case 144: // VK_FORMAT_BC6H_SFLOAT_BLOCK
+			return Image::FORMAT_BPTC_RGBF;
+		case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+		case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+			return Image::FORMAT_BPTC_RGBA;
+		case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+		case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+			return Image::FORMAT_ETC2_RGB8;
+		case 149: // VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK
+		case 150: // VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK
+			return Image::FORMAT_ETC2_RGB8A1;
+		case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+		case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+			return Image::FORMAT_ETC2_RGBA8;
+		case 153: // VK_FORMAT_EAC_R11_UNORM_BLOCK
+			return Image::FORMAT_ETC2_R11;
+		case 154: // VK_FORMAT_EAC_R11_SNORM_BLOCK
+			return Image::FORMAT_ETC2_R11S;
+		case 155: // VK_FORMAT_EAC_R11G11_UNORM_BLOCK
+			return Image::FORMAT_ETC2_RG11;
+		case 156: // VK_FORMAT_EAC_R11G11_SNORM_BLOCK
+			return Image::FORMAT_ETC2_RG11S;
+		default:
+			return -1;
+	}
+}
+
+// Loads a KTX2 container holding a format Godot can upload directly, keeping
+// block-compressed data compressed. Basis Universal payloads (ETC1S/UASTC)
+// and supercompressed levels return ERR_UNAVAILABLE, there is no transcoder
+// in this module. Reads p_size bytes at p_data in place, so the container
+// may be a slice of a larger buffer.
+// Ref: https://github.khronos.org/KTX-Specification/
+static Error _load_ktx2_from_buffer(const uint8_t *p_data, int p_size, Ref<Image> r_image) {
+	const int HEADER_SIZE = 80;
+	const int LEVEL_SIZE = 24;
+	ERR_FAIL_COND_V(p_size < 12 || memcmp(p_data, KTX2_IDENTIFIER, 12) != 0, ERR_FILE_UNRECOGNIZED);
+	ERR_FAIL_COND_V(p_size < HEADER_SIZE, ERR_FILE_CORRUPT);
+	const uint8_t *ptr = p_data;
+
+	uint32_t header[9];
+	memcpy(header, ptr + 12, sizeof(header));
+	const uint32_t vk_format = header[0];
+	const uint32_t width = header[2];
+	const uint32_t height = header[3];
+	const uint32_t depth = header[4];
+	const uint32_t layer_count = header[5];
+	const uint32_t face_count = header[6];
+	const uint32_t level_count = MAX(header[7], 1u);
+	const uint32_t supercompression = header[8];
+
+	if (vk_format == 0 || supercompression != 0) {
+		return ERR_UNAVAILABLE;
+	}
+	const int format = _ktx2_vk_format_to_image_format(vk_format);
+	if (format < 0) {
+		return ERR_UNAVAILABLE;
+	}
+	ERR_FAIL_COND_V(width == 0 || height == 0 || depth > 1 || layer_count > 1 || face_count != 1, ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V(level_count > (uint32_t)(p_size - HEADER_SIZE) / LEVEL_SIZE, ERR_FILE_CORRUPT);
+
+	// Godot expects the full mip chain down to 1x1, and its block size maths
+	// only matches KTX2 for power of two sizes. Anything else keeps level 0.
+	const bool power_of_two = (width & (width - 1)) == 0 && (height & (height - 1)) == 0;
+	uint32_t full_chain = 1;
+	for (uint32_t size = MAX(width, height); size > 1; size >>= 1) {
+		full_chain++;
+	}
+	const uint32_t used_levels = (power_of_two && level_count == full_chain) ? level_count : 1;
+	const bool is_block_format = format >= Image::FORMAT_DXT1;
+	ERR_FAIL_COND_V(used_levels == 1 && is_block_format && (width % 4 || height % 4), ERR_UNAVAILABLE);
+
+	// Levels are indexed largest first, which is also the order Image wants.
+	// Offsets and lengths are checked separately, their sum could wrap.
+	const uint64_t data_size = p_size;
+	uint64_t total_size = 0;
+	for (uint32_t level_i = 0; level_i < used_levels; level_i++) {
+		uint64_t level[3];
+		memcpy(level, ptr + HEADER_SIZE + level_i * LEVEL_SIZE, sizeof(level));
+		ERR_FAIL_COND_V(level[0] > data_size || level[1] > data_size - level[0], ERR_FILE_CORRUPT);
+		total_size += level[1];
+	}
+	ERR_FAIL_COND_V(total_size > (uint64_t)std::numeric_limits<int>::max(), ERR_FILE_CORRUPT);
+	PoolByteArray image_data;
+	image_data.resize(total_size);
+	{
+		PoolByteArray::Write w = image_data.write();
+		uint64_t write_offset = 0;
+		for (uint32_t level_i = 0; level_i < used_levels; level_i++) {
+			uint64_t level[3];
+			memcpy(level, ptr + HEADER_SIZE + level_i * LEVEL_SIZE, sizeof(level));
+			memcpy(w.ptr() + write_offset, ptr + level[0], level[1]);
+			write_offset += level[1];
+		}
+	}
+	r_image->create_from_data(width, height, used_levels > 1, format, image_data);
+	ERR_FAIL_COND_V(r_image->is_empty(), ERR_FILE_CORRUPT);
+	return OK;
+}
+
+// Reads the pixel size of PNG, WebP and JPEG data from its header, without decoding.
+static bool _read_image_header_size(const uint8_t *p_data, int p_size, int &r_width, int &r_height) {
+	static const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+	if (p_size >= 24 && memcmp(p_data, PNG_SIGNATURE, 8) == 0) {
+		// The IHDR chunk always comes first.
+		r_width = (p_data[16] << 24) | (p_data[17] << 16) | (p_data[18] << 8) | p_data[19];
+		r_height = (p_data[20] << 24) | (p_data[21] << 16) | (p_data[22] << 8) | p_data[23];
+		return r_width > 0 && r_height > 0;
+	}
+	if (p_size >= 30 && memcmp(p_data, "RIFF", 4) == 0 && memcmp(p_data + 8, "WEBP", 4) == 0) {
+		// Ref: https://developers.google.com/speed/webp/docs/riff_container
+		const uint8_t *chunk = p_data + 12;
+		if (memcmp(chunk, "VP8 ", 4) == 0) {
+			r_width = ((chunk[15] << 8) | chunk[14]) & 0x3FFF;
+			r_height = ((chunk[17] << 8) | chunk[16]) & 0x3FFF;
+		} else if (memcmp(chunk, "VP8L", 4) == 0) {
+			const uint32_t bits = chunk[9] | (chunk[10] << 8) | (chunk[11] << 16) | ((uint32_t)chunk[12] << 24);
+			r_width = (bits & 0x3FFF) + 1;
+			r_height = ((bits >> 14) & 0x3FFF) + 1;
+		} else if (memcmp(chunk, "VP8X", 4) == 0) {
+			r_width = (chunk[12] | (chunk[13] << 8) | (chunk[14] << 16)) + 1;
+			r_height = (chunk[15] | (chunk[16] << 8) | (chunk[17] << 16)) + 1;
+		} else {
+			return false;
+		}
+		return r_width > 0 && r_height > 0;
+	}
+	if (p_size >= 4 && p_data[0] == 0xFF && p_data[1] == 0xD8) {
+		int pos = 2;
+		while (pos + 4 <= p_size) {
+			if (p_data[pos] != 0xFF) {
+				return false;
+			}
+			const uint8_t marker = p_data[pos + 1];
+			if (marker == 0xFF) { // Fill byte.
+				pos++;
+				continue;
+			}
+			if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD9)) { // No payload.
+				pos += 2;
+				continue;
+			}
+			const int length = (p_data[pos + 2] << 8) | p_data[pos + 3];
+			const bool is_sof = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+			if (is_sof && pos + 9 <= p_size) {
+				r_height = (p_data[pos + 5] << 8) | p_data[pos + 6];
+				r_width = (p_data[pos + 7] << 8) | p_data[pos + 8];
+				return r_width > 0 && r_height > 0;
+			}
+			pos += 2 + length;
+		}
+	}
+	return false;
+}
+
+// A cached image is only used when it is what compressing the source would
+// produce now: compressed with the current mode, mipmapped and at the size
+// the header and size limit give. Anything else is treated as a miss.
+static bool _is_cached_image_valid(Ref<Image> p_image, const GLTFImageSource &p_source, int p_compress_mode) {
+	if (!p_image->is_compressed() || !p_image->has_mipmaps()) {
+		return false;
+	}
+	const int format = p_image->get_format();
+	bool format_valid = false;
+	switch (p_compress_mode) {
+		case Image::COMPRESS_S3TC:
+			format_valid = format == Image::FORMAT_DXT1 || format == Image::FORMAT_DXT3 || format == Image::FORMAT_DXT5 ||
+						   format == Image::FORMAT_RGTC_R || format == Image::FORMAT_RGTC_RG;
+			break;
+		case Image::COMPRESS_PVRTC2:
+			format_valid = format == Image::FORMAT_PVRTC2 || format == Image::FORMAT_PVRTC2A;
+			break;
+		case Image::COMPRESS_PVRTC4:
+			format_valid = format == Image::FORMAT_PVRTC4 || format == Image::FORMAT_PVRTC4A;
+			break;
+		case Image::COMPRESS_ETC:
+			format_valid = format == Image::FORMAT_ETC;
+			break;
+		case Image::COMPRESS_ETC2:
+			format_valid = format >= Image::FORMAT_ETC2_R11 && format <= Image::FORMAT_ETC2_RGB8A1;
+			break;
+		default:
+			break;
+	}
+	if (!format_valid) {
+		return false;
+	}
+
+	int width = 0;
+	int height = 0;
+	PoolByteArray::Read data_read = p_source.data.read();
+	if (!_read_image_header_size(data_read.ptr() + p_source.offset, p_source.size, width, height)) {
+		return false;
+	}
+	const int max_side = MAX(width, height);
+	if (p_source.max_size > 0 && max_side > p_source.max_size) {
+		const double scale = (double)p_source.max_size / max_side;
+		width = MAX((int)(width * scale), 1);
+		height = MAX((int)(height * scale), 1);
+	}
+	return p_image->get_width() == width && p_image->get_height() == height;
+}
+
+std::vector<int> GLTFDocument::_get_image_size_limits(Ref<GLTFState> state) {
+	const int image_count = state->image_sources.size();
+	std::vector<int> limits(image_count, state->texture_max_size > 0 ? state->texture_max_size : 0);
+	if (!state->json.has("textures") || !state->json.has("materials")) {
+		return limits;
+	}
+
+	// The per-usage limits apply to every image a material slot of that
+	// usage references, the smallest limit wins.
+	const Array &textures = state->json["textures"];
+	auto limit_texture = [&](const Dictionary &p_slot, const String &p_key, int p_limit) {
+		if (p_limit <= 0 || !p_slot.has(p_key)) {
+			return;
+		}
+		const Dictionary &texture_info = p_slot[p_key];
+		if (!texture_info.has("index")) {
+			return;
+		}
+		const int texture_i = texture_info["index"];
+		if (texture_i < 0 || texture_i >= textures.size()) {
+			return;
+		}
+		const std::vector<GLTFImageIndex> images = _get_texture_image_sources(textures[texture_i]);
+		for (size_t i = 0; i < images.size(); i++) {
+			const int image_i = images[i];
+			if (image_i >= 0 && image_i < image_count) {
+				limits[image_i] = limits[image_i] > 0 ? MIN(limits[image_i], p_limit) : p_limit;
+			}
+		}
+	};
+
+	const Array &materials = state->json["materials"];
+	for (int i = 0; i < materials.size(); i++) {
+		const Dictionary &d = materials[i];
+		limit_texture(d, "normalTexture", state->texture_max_size_normal);
+		limit_texture(d, "occlusionTexture", state->texture_max_size_orm);
+		limit_texture(d, "emissiveTexture", state->texture_max_size_albedo);
+		if (d.has("pbrMetallicRoughness")) {
+			const Dictionary &mr = d["pbrMetallicRoughness"];
+			limit_texture(mr, "baseColorTexture", state->texture_max_size_albedo);
+			limit_texture(mr, "metallicRoughnessTexture", state->texture_max_size_orm);
+		}
+		if (d.has("extensions")) {
+			const Dictionary &extensions = d["extensions"];
+			if (extensions.has("KHR_materials_pbrSpecularGlossiness")) {
+				const Dictionary &sgm = extensions["KHR_materials_pbrSpecularGlossiness"];
+				limit_texture(sgm, "diffuseTexture", state->texture_max_size_albedo);
+				limit_texture(sgm, "specularGlossinessTexture", state->texture_max_size_orm);
+			}
+		}
+	}
+	return limits;
+}
+
+std::vector<bool> GLTFDocument::_get_color_images(Ref<GLTFState> state) {
+	// Images only referenced by normal, occlusion, metallic-roughness or
+	// specular-glossiness slots hold data rather than colors.
+	const int image_count = state->image_sources.size();
+	std::vector<bool> color(image_count, true);
+	if (!state->json.has("textures") || !state->json.has("materials")) {
+		return color;
+	}
+	std::vector<int> color_uses(image_count, 0);
+	std::vector<int> data_uses(image_count, 0);
+	const Array &textures = state->json["textures"];
+	auto use_texture = [&](const Dictionary &p_slot, const String &p_key, std::vector<int> &r_uses) {
+		if (!p_slot.has(p_key)) {
+			return;
+		}
+		const Dictionary &texture_info = p_slot[p_key];
+		if (!texture_info.has("index")) {
+			return;
+		}
+		const int texture_i = texture_info["index"];
+		if (texture_i < 0 || texture_i >= textures.size()) {
+			return;
+		}
+		const std::vector<GLTFImageIndex> images = _get_texture_image_sources(textures[texture_i]);
+		for (size_t i = 0; i < images.size(); i++) {
+			if (images[i] >= 0 && images[i] < image_count) {
+				r_uses[images[i]]++;
+			}
+		}
+	};
+
+	const Array &materials = state->json["materials"];
+	for (int i = 0; i < materials.size(); i++) {
+		const Dictionary &d = materials[i];
+		use_texture(d, "normalTexture", data_uses);
+		use_texture(d, "occlusionTexture", data_uses);
+		use_texture(d, "emissiveTexture", color_uses);
+		if (d.has("pbrMetallicRoughness")) {
+			const Dictionary &mr = d["pbrMetallicRoughness"];
+			use_texture(mr, "baseColorTexture", color_uses);
+			use_texture(mr, "metallicRoughnessTexture", data_uses);
+		}
+		if (d.has("extensions")) {
+			const Dictionary &extensions = d["extensions"];
+			if (extensions.has("KHR_materials_pbrSpecularGlossiness")) {
+				const Dictionary &sgm = extensions["KHR_materials_pbrSpecularGlossiness"];
+				use_texture(sgm, "diffuseTexture", color_uses);
+				use_texture(sgm, "specularGlossinessTexture", data_uses);
+			}
+		}
+	}
+	for (int i = 0; i < image_count; i++) {
+		color[i] = color_uses[i] > 0 || data_uses[i] == 0;
+	}
+	return color;
+}
+
+std::vector<int> GLTFDocument::_get_image_texture_flags(Ref<GLTFState> state, int &r_conflicts) {
+	// Godot keeps sampling state on the texture, so each image takes the
+	// sampler of the first texture using it. Textures pairing the same image
+	// with a different sampler are counted as conflicts.
+	const int image_count = state->image_sources.size();
+	std::vector<int> flags(image_count, -1);
+	r_conflicts = 0;
+	if (!state->json.has("textures")) {
+		return flags;
+	}
+	const Array &textures = state->json["textures"];
+	const Array samplers = state->json.has("samplers") ? (Array)state->json["samplers"] : Array();
+	for (int texture_i = 0; texture_i < textures.size(); texture_i++) {
+		const Dictionary &t = textures[texture_i];
+		Dictionary sampler;
+		if (t.has("sampler")) {
+			const int sampler_i = t["sampler"];
+			if (sampler_i >= 0 && sampler_i < samplers.size()) {
+				sampler = samplers[sampler_i];
+			}
+		}
+		const int texture_flags = _get_sampler_texture_flags(sampler);
+
+		const std::vector<GLTFImageIndex> images = _get_texture_image_sources(t);
+		for (size_t i = 0; i < images.size(); i++) {
+			const int image_i = images[i];
+			if (image_i < 0 || image_i >= image_count) {
+				continue;
+			}
+			if (flags[image_i] == -1) {
+				flags[image_i] = texture_flags;
+			} else if (flags[image_i] != texture_flags) {
+				r_conflicts++;
+			}
+		}
+	}
+	return flags;
+}
+
+void GLTFDocument::_apply_texture_budget(Ref<GLTFState> state) {
+	std::vector<GLTFImageSource> &sources = state->image_sources;
+	const std::vector<int> limits = _get_image_size_limits(state);
+
+	// Sizes come from the image headers, so the plan only depends on the
+	// file and the settings and decoded results stay valid for caching.
+	std::vector<int> widths(sources.size(), 0);
+	std::vector<int> heights(sources.size(), 0);
+	for (size_t i = 0; i < sources.size(); i++) {
+		GLTFImageSource &source = sources[i];
+		if (source.err != OK || source.is_ktx2) {
+			continue;
+		}
+		source.max_size = limits[i];
+		PoolByteArray::Read data_read = source.data.read();
+		_read_image_header_size(data_read.ptr() + source.offset, source.size, widths[i], heights[i]);
+	}
+	if (state->texture_budget_mb <= 0.0f) {
+		return;
+	}
+
+	// Halve the largest image until the estimated total, including mipmaps,
+	// fits in the budget. Ties go to the lowest index to stay deterministic.
+	const int64_t budget = (int64_t)(state->texture_budget_mb * 1024 * 1024);
+	const int bytes_per_pixel = state->compress_textures ? 1 : 4;
+	auto scaled_size = [&](int p_index) -> int64_t {
+		const int max_side = MAX(widths[p_index], heights[p_index]);
+		const int limit = sources[p_index].max_size;
+		const double scale = (limit > 0 && max_side > limit) ? (double)limit / max_side : 1.0;
+		const int64_t w = MAX((int64_t)(widths[p_index] * scale), (int64_t)1);
+		const int64_t h = MAX((int64_t)(heights[p_index] * scale), (int64_t)1);
+		return w * h * bytes_per_pixel * 4 / 3;
+	};
+	int64_t total = 0;
+	for (size_t i = 0; i < sources.size(); i++) {
+		if (widths[i] > 0) {
+			total += scaled_size(i);
+		}
+	}
+	while (total > budget) {
+		int largest = -1;
+		int64_t largest_size = 0;
+		for (size_t i = 0; i < sources.size(); i++) {
+			if (widths[i] > 0 && scaled_size(i) > largest_size) {
+				largest = i;
+				largest_size = scaled_size(i);
+			}
+		}
+		if (largest == -1 || largest_size <= 4 * bytes_per_pixel) {
+			break;
+		}
+		GLTFImageSource &source = sources[largest];
+		const int current = source.max_size > 0 ? MIN(source.max_size, MAX(widths[largest], heights[largest])) : MAX(widths[largest], heights[largest]);
+		source.max_size = MAX(current / 2, 1);
+		total += scaled_size(largest) - largest_size;
+	}
+}
+
+Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_path) {
+	if (!state->json.has("images")) {
+		return OK;
+	}
+
+	// Ref: https://github.com/KhronosGroup/glTF/blob/master/specification/2.0/README.md#images
+
+	// Encoded bytes of every image are resolved on the calling thread since
+	// external files go through WebRequest, decoding happens later.
 	const Array &images = state->json["images"];
+	std::vector<GLTFImageSource> &sources = state->image_sources;
+	sources.clear();
+	sources.resize(images.size());
 	for (int i = 0; i < images.size(); i++) {
 		const Dictionary &d = images[i];
 
@@ -3221,7 +5426,7 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 		}
 
 		String mimetype;
-		if (d.has("mimeType")) { // Should be "image/png" or "image/jpeg".
+		if (d.has("mimeType")) { // Should be "image/png", "image/jpeg", "image/ktx2" (raw-format KTX2 only) or "image/webp" (EXT_texture_webp).
 			mimetype = d["mimeType"];
 		}
 
@@ -3238,10 +5443,11 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 				if (!uri.begins_with_char_array("data:application/octet-stream;base64") &&
 						!uri.begins_with_char_array("data:application/gltf-buffer;base64") &&
 						!uri.begins_with_char_array("data:image/png;base64") &&
-						!uri.begins_with_char_array("data:image/jpeg;base64")) {
+						!uri.begins_with_char_array("data:image/jpeg;base64") &&
+						!uri.begins_with_char_array("data:image/webp;base64") &&
+						!uri.begins_with_char_array("data:image/ktx2;base64")) {
 					WARN_PRINT(str_format("glTF: Image index '{0}' uses an unsupported URI data type: {1}. Skipping it.", i, uri));
-					state->images.push_back(Ref<Texture>()); // Placeholder to keep count.
-					continue;
+					continue; // Left as a placeholder to keep count.
 				}
 				data_tmp = _parse_base64_uri(uri);
 				data_size = data_tmp.size();
@@ -3251,6 +5457,10 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 						mimetype = "image/png";
 					} else if (uri.begins_with_char_array("data:image/jpeg;base64")) {
 						mimetype = "image/jpeg";
+					} else if (uri.begins_with_char_array("data:image/webp;base64")) {
+						mimetype = "image/webp";
+					} else if (uri.begins_with_char_array("data:image/ktx2;base64")) {
+						mimetype = "image/ktx2";
 					}
 				}
 			} else { // Relative path to an external image file.
@@ -3260,8 +5470,7 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 
 				if (data_tmp.size() == 0) {
 					WARN_PRINT(str_format("glTF: Image index '{0}' couldn't be loaded as a buffer of MIME type '{1}' from URI: {2}. Skipping it.", i, mimetype, uri));
-					state->images.push_back(Ref<Texture>()); // Placeholder to keep count.
-					continue;
+					continue; // Left as a placeholder to keep count.
 				}
 			}
 		} else if (d.has("bufferView")) {
@@ -3287,48 +5496,524 @@ Error GLTFDocument::_parse_images(Ref<GLTFState> state, const String &p_base_pat
 		ERR_CONTINUE_MSG(data_size <= 0 || data_offset < 0, "Invalid data_size");
 		ERR_CONTINUE_MSG(data_size + data_offset > data_tmp.size(), "Data size out of bounds");
 
-		Ref<Image> img;
-		img.instance();
+		GLTFImageSource &source = sources[i];
+		source.data = data_tmp;
+		source.offset = data_offset;
+		source.size = data_size;
+		source.mimetype = mimetype;
+		source.err = OK;
+		if (mimetype == "image/ktx2") {
+			source.is_ktx2 = true;
+		} else {
+			PoolByteArray::Read data_read = data_tmp.read();
+			source.is_ktx2 = data_size >= 12 && memcmp(data_read.ptr() + data_offset, KTX2_IDENTIFIER, 12) == 0;
+		}
+	}
+
+	_apply_texture_budget(state);
+	if (state->threaded_mipmaps) {
+		const std::vector<bool> color_images = _get_color_images(state);
+		for (size_t i = 0; i < sources.size(); i++) {
+			sources[i].srgb = color_images[i];
+		}
+	}
+	int sampler_conflicts = 0;
+	if (state->import_samplers) {
+		const std::vector<int> texture_flags = _get_image_texture_flags(state, sampler_conflicts);
+		for (size_t i = 0; i < sources.size(); i++) {
+			sources[i].texture_flags = texture_flags[i];
+		}
+	}
+
+	// Content keys for the resource registry, the texture cache and material
+	// deduplication, which tells materials apart by their textures' keys.
+	if (state->share_resources || state->deduplicate_materials || (state->compress_textures && !state->texture_cache_path.empty())) {
+		ThreadWorkPool::do_work(sources.size(), state->worker_thread_count, [&](int p_index) {
+			GLTFImageSource &source = sources[p_index];
+			if (source.err != OK) {
+				return;
+			}
+			PoolByteArray::Read data_read = source.data.read();
+			uint64_t key = gltf_hash_bytes(data_read.ptr() + source.offset, source.size);
+			key = gltf_hash_int(state->compress_textures, key);
+			key = gltf_hash_int(state->texture_compress_mode, key);
+			key = gltf_hash_int(source.max_size, key);
+			if (state->threaded_mipmaps) {
+				key = gltf_hash_int(source.srgb ? 2 : 1, key);
+			}
+			if (source.texture_flags >= 0) {
+				key = gltf_hash_int(source.texture_flags, key);
+			}
+			source.key = key;
+		});
+	}
+
+	Dictionary stats;
+	stats["count"] = (int)sources.size();
+	stats["decoded"] = 0;
+	stats["ktx2_unsupported"] = 0;
+	stats["downscaled"] = Array();
+	if (state->compress_textures) {
+		stats["compressed"] = 0;
+		stats["cache_hits"] = 0;
+		stats["cache_misses"] = 0;
+	}
+	stats["threads"] = state->worker_thread_count > 0 ? state->worker_thread_count : ThreadWorkPool::get_default_thread_count();
+	stats["decode_msec"] = 0.0;
+	stats["timings"] = Array();
+	state->import_stats["images"] = stats;
+	if (state->import_samplers) {
+		Dictionary sampler_stats;
+		sampler_stats["samplers"] = state->json.has("samplers") ? ((Array)state->json["samplers"]).size() : 0;
+		sampler_stats["conflicts"] = sampler_conflicts;
+		state->import_stats["samplers"] = sampler_stats;
+	}
+
+	// KHR_texture_basisu and EXT_texture_webp images fall back to the
+	// texture's next source.
+	if (state->json.has("textures")) {
+		std::vector<bool> primary(sources.size(), false);
+		std::vector<bool> fallback(sources.size(), false);
+		const Array &textures = state->json["textures"];
+		for (int texture_i = 0; texture_i < textures.size(); texture_i++) {
+			const std::vector<GLTFImageIndex> images = _get_texture_image_sources(textures[texture_i]);
+			int previous = -1;
+			for (size_t image_i = 0; image_i < images.size(); image_i++) {
+				const GLTFImageIndex image = images[image_i];
+				if (image < 0 || image >= (int)sources.size()) {
+					continue;
+				}
+				if (previous < 0) {
+					primary[image] = true;
+				} else {
+					fallback[image] = true;
+					if (sources[previous].fallback < 0) {
+						sources[previous].fallback = image;
+					}
+				}
+				previous = image;
+			}
+		}
+		for (size_t i = 0; i < sources.size(); i++) {
+			sources[i].fallback_only = fallback[i] && !primary[i];
+		}
+	}
+
+	// With lazy textures every image starts out as an empty ProxyTexture that
+	// materials can reference, the real texture is set as its base once the
+	// image is materialized. A failed image's proxy gets its fallback's
+	// texture.
+	std::vector<int> to_decode;
+	for (size_t i = 0; i < sources.size(); i++) {
+		if (sources[i].err == ERR_SKIP) {
+			state->images.push_back(Ref<Texture>()); // Placeholder to keep count.
+		} else if (state->lazy_textures) {
+			Ref<ProxyTexture> proxy;
+			proxy.instance();
+			state->images.push_back(proxy);
+		} else {
+			state->images.push_back(Ref<Texture>());
+			if (!sources[i].fallback_only) {
+				to_decode.push_back(i);
+			}
+		}
+	}
+	_decode_images(state, to_decode);
+	if (state->lazy_textures && state->texture_prefetch_budget > 0) {
+		prefetch_images(state, state->texture_prefetch_budget);
+	}
+
+	print_verbose("glTF: Total images: " + itos(state->images.size()));
+
+	return OK;
+}
+
+void GLTFDocument::_decode_images(Ref<GLTFState> state, const std::vector<int> &p_images) {
+	std::vector<GLTFImageSource> &sources = state->image_sources;
+	if (p_images.empty()) {
+		return;
+	}
+
+	// Textures already imported with the same content are reused as they are.
+	if (state->share_resources) {
+		for (size_t list_i = 0; list_i < p_images.size(); list_i++) {
+			const int i = p_images[list_i];
+			GLTFImageSource &source = sources[i];
+			if (source.err != OK || source.decoded) {
+				continue;
+			}
+			Ref<Texture> shared = GLTFResourceRegistry::find("images", source.key);
+			if (shared.is_null()) {
+				continue;
+			}
+			source.decoded = true;
+			source.data = PoolByteArray();
+			Ref<ProxyTexture> proxy = state->images[i];
+			if (proxy.is_valid()) {
+				proxy->set_base(shared);
+			} else {
+				state->images.write[i] = shared;
+			}
+		}
+	}
+
+	const bool use_texture_cache = state->compress_textures && !state->texture_cache_path.empty();
+	if (use_texture_cache) {
+		Ref<Directory> dir;
+		dir.instance();
+		if (!dir->dir_exists(state->texture_cache_path)) {
+			dir->make_dir_recursive(state->texture_cache_path);
+		}
+	}
 
-		PoolByteArray::Read data_tmp_read = data_tmp.read();
-		const uint8_t *data_ptr = data_tmp_read.ptr() + data_offset;
+	// Decoding dominates the import time of texture-heavy assets and only
+	// touches the source bytes, so it runs on the worker threads.
+	const uint64_t begin_time = OS::get_singleton()->get_ticks_usec();
+	ThreadWorkPool::do_work(p_images.size(), state->worker_thread_count, [&](int p_index) {
+		GLTFImageSource &source = sources[p_images[p_index]];
+		if (source.err != OK || source.decoded) {
+			return;
+		}
+		String cache_file;
+		if (use_texture_cache) {
+			cache_file = _get_texture_cache_file(state->texture_cache_path, gltf_hash_int(GLTF_TEXTURE_CACHE_VERSION, source.key));
+			Ref<Image> cached = _load_cached_image(cache_file);
+			if (cached.is_valid() && _is_cached_image_valid(cached, source, state->texture_compress_mode)) {
+				if (state->keep_source_images) {
+					source.encoded = _get_image_source_bytes(source);
+					source.pixel_hash = _hash_image_pixels(cached);
+				}
+				source.data = PoolByteArray();
+				source.image = cached;
+				source.cache_hit = true;
+				return;
+			}
+		}
+		uint64_t step_time = OS::get_singleton()->get_ticks_usec();
+		// KTX2 is read in place, even from a slice of the GLB BIN chunk; the
+		// engine decoders need a PoolByteArray of their own.
+		const PoolByteArray data_buf = source.is_ktx2 ? PoolByteArray() : _get_image_source_bytes(source);
+		if (state->keep_source_images) {
+			source.encoded = source.is_ktx2 ? _get_image_source_bytes(source) : data_buf;
+		}
 
-		PoolByteArray data_buf;
-		data_buf.resize(data_size);
-		PoolByteArray::Write data_buf_wr = data_buf.write();
-		uint8_t *out_data_ptr = data_buf_wr.ptr();
-		memcpy(out_data_ptr, data_ptr, data_size);
+		Ref<Image> img;
+		img.instance();
 		Error err = OK;
-		if (mimetype == "image/png") { // Load buffer as PNG.
+		if (source.is_ktx2) { // Upload KTX2 levels as they are.
+			PoolByteArray::Read data_read = source.data.read();
+			err = _load_ktx2_from_buffer(data_read.ptr() + source.offset, source.size, img);
+		} else if (source.mimetype == "image/png") { // Load buffer as PNG.
 			err = img->load_png_from_buffer(data_buf);
-		} else if (mimetype == "image/jpeg") { // Loader buffer as JPEG.
-			err =img->load_jpg_from_buffer(data_buf);
+		} else if (source.mimetype == "image/jpeg") { // Loader buffer as JPEG.
+			err = img->load_jpg_from_buffer(data_buf);
+		} else if (source.mimetype == "image/webp") { // Load buffer as WebP.
+			err = img->load_webp_from_buffer(data_buf);
 		} else {
 			// We can land here if we got an URI with base64-encoded data with application/* MIME type,
 			// and the optional mimeType property was not defined to tell us how to handle this data (or was invalid).
-			// So let's try PNG first, then JPEG.
+			// So let's try PNG first, then JPEG, then WebP.
 			err = img->load_png_from_buffer(data_buf);
 			if (err != OK) {
 				err = img->load_jpg_from_buffer(data_buf);
 			}
+			if (err != OK) {
+				err = img->load_webp_from_buffer(data_buf);
+			}
 		}
-
+		// Drop our handle so standalone encoded data is freed as soon as it
+		// has been decoded rather than at the end of the pass.
+		source.data = PoolByteArray();
+		source.err = err;
 		if (err != OK) {
-			ERR_PRINT(str_format("glTF: Couldn't load image index '{0}' with its given mimetype: ", i) + mimetype);
-			state->images.push_back(Ref<Texture>());
+			return;
+		}
+		source.image = img;
+
+		const int max_side = MAX(img->get_width(), img->get_height());
+		if (source.max_size > 0 && max_side > source.max_size && !img->is_compressed()) {
+			const double scale = (double)source.max_size / max_side;
+			source.original_width = img->get_width();
+			source.original_height = img->get_height();
+			img->resize(MAX((int)(img->get_width() * scale), 1), MAX((int)(img->get_height() * scale), 1), Image::INTERPOLATE_LANCZOS);
+		}
+		source.decode_usec = OS::get_singleton()->get_ticks_usec() - step_time;
+
+		// With complete mip chains, creating the texture is a plain upload.
+		if (state->threaded_mipmaps) {
+			step_time = OS::get_singleton()->get_ticks_usec();
+			_generate_image_mipmaps(img, source.srgb, 1);
+			source.mipmap_usec = OS::get_singleton()->get_ticks_usec() - step_time;
+		}
+
+		if (state->compress_textures && !img->is_compressed()) {
+			step_time = OS::get_singleton()->get_ticks_usec();
+			const int width = img->get_width();
+			const int height = img->get_height();
+			// A failed compression leaves the mipmapped RGBA image in place.
+			if (!img->has_mipmaps()) {
+				img->generate_mipmaps();
+			}
+			if (img->compress(state->texture_compress_mode, Image::COMPRESS_SOURCE_GENERIC, 0.7f) == OK &&
+					img->is_compressed() && img->has_mipmaps() &&
+					img->get_width() == width && img->get_height() == height) {
+				source.compressed = true;
+				if (!cache_file.empty()) {
+					_store_cached_image(cache_file, img);
+				}
+			}
+			source.compress_usec = OS::get_singleton()->get_ticks_usec() - step_time;
+		}
+		if (state->keep_source_images) {
+			source.pixel_hash = _hash_image_pixels(img);
+		}
+	});
+	const uint64_t decode_usec = OS::get_singleton()->get_ticks_usec() - begin_time;
+
+	// Textures are created on the calling thread, in image order.
+	Dictionary stats = state->import_stats["images"];
+	std::vector<int> failed;
+	for (size_t list_i = 0; list_i < p_images.size(); list_i++) {
+		const int i = p_images[list_i];
+		GLTFImageSource &source = sources[i];
+		if (source.decoded || source.err == ERR_SKIP) {
+			continue;
+		}
+		source.decoded = true;
+		source.data = PoolByteArray();
+		if (source.err != OK && source.fallback >= 0) {
+			failed.push_back(i);
+		}
+		if (source.err == ERR_UNAVAILABLE && source.is_ktx2) {
+			// Only raw-format KTX2 is supported, there is no Basis Universal
+			// transcoder. Textures referencing it use their fallback source.
+			if (source.fallback >= 0) {
+				WARN_PRINT(str_format("glTF: Image index '{0}' is a KTX2 image with Basis Universal (ETC1S/UASTC) data or supercompression, which can't be transcoded. Falling back to image index '{1}'.", i, source.fallback));
+			} else {
+				WARN_PRINT(str_format("glTF: Image index '{0}' is a KTX2 image with Basis Universal (ETC1S/UASTC) data or supercompression, which can't be transcoded, and has no fallback image. Skipping it.", i));
+			}
+			stats["ktx2_unsupported"] = (int)stats["ktx2_unsupported"] + 1;
+			continue;
+		}
+		if (source.err != OK) {
+			ERR_PRINT(str_format("glTF: Couldn't load image index '{0}' with its given mimetype: ", i) + source.mimetype);
 			continue;
 		}
 
+		const uint64_t upload_time = OS::get_singleton()->get_ticks_usec();
 		Ref<ImageTexture> t;
 		t.instance();
-		t->create_from_image(img);
+		if (source.texture_flags >= 0) {
+			t->create_from_image(source.image, source.texture_flags);
+		} else {
+			t->create_from_image(source.image);
+		}
+		const uint64_t upload_usec = OS::get_singleton()->get_ticks_usec() - upload_time;
+		source.decoded_size = source.image->get_data().size();
+		source.image = Ref<Image>();
+
+		Dictionary timing;
+		timing["image"] = i;
+		timing["decode_msec"] = (real_t)(source.decode_usec / 1000.0);
+		timing["mipmap_msec"] = (real_t)(source.mipmap_usec / 1000.0);
+		timing["compress_msec"] = (real_t)(source.compress_usec / 1000.0);
+		timing["upload_msec"] = (real_t)(upload_usec / 1000.0);
+		Array timings = stats["timings"];
+		timings.push_back(timing);
+
+		Ref<ProxyTexture> proxy = state->images[i];
+		if (proxy.is_valid()) {
+			proxy->set_base(t);
+		} else {
+			state->images.write[i] = t;
+		}
+		if (state->keep_source_images && (source.mimetype == "image/png" || source.mimetype == "image/jpeg")) {
+			// Lets the exporter write the original file while the pixels are unchanged.
+			Array textures;
+			textures.push_back(t);
+			textures.push_back(proxy);
+			for (int texture_i = 0; texture_i < textures.size(); texture_i++) {
+				Ref<Texture> texture = textures[texture_i];
+				if (texture.is_null()) {
+					continue;
+				}
+				texture->set_meta("gltf_source_data", source.encoded);
+				texture->set_meta("gltf_source_mime_type", source.mimetype);
+				texture->set_meta("gltf_source_pixel_hash", (int64_t)source.pixel_hash);
+			}
+		}
+		source.encoded = PoolByteArray();
+		if (state->share_resources) {
+			GLTFResourceRegistry::add(source.key, t);
+		}
+		stats["decoded"] = (int)stats["decoded"] + 1;
+		if (source.original_width > 0) {
+			Dictionary reduced;
+			reduced["image"] = i;
+			reduced["from"] = Vector2(source.original_width, source.original_height);
+			reduced["to"] = Vector2(t->get_width(), t->get_height());
+			Array downscaled = stats["downscaled"];
+			downscaled.push_back(reduced);
+		}
+		if (state->compress_textures) {
+			stats["compressed"] = (int)stats["compressed"] + source.compressed;
+			stats["cache_hits"] = (int)stats["cache_hits"] + source.cache_hit;
+			stats["cache_misses"] = (int)stats["cache_misses"] + (use_texture_cache && !source.cache_hit);
+		}
+	}
+	stats["decode_msec"] = (real_t)stats["decode_msec"] + (real_t)(decode_usec / 1000.0);
 
-		state->images.push_back(t);
+	// Fallback sources are only decoded once the image they stand in for has
+	// failed, lazy textures then take the fallback's texture as their base.
+	if (failed.empty()) {
+		return;
+	}
+	std::vector<int> fallbacks;
+	for (size_t failed_i = 0; failed_i < failed.size(); failed_i++) {
+		fallbacks.push_back(sources[failed[failed_i]].fallback);
+	}
+	_decode_images(state, fallbacks);
+	for (size_t failed_i = 0; failed_i < failed.size(); failed_i++) {
+		Ref<ProxyTexture> proxy = state->images[failed[failed_i]];
+		if (proxy.is_null()) {
+			continue;
+		}
+		Ref<Texture> fallback = state->images[sources[failed[failed_i]].fallback];
+		Ref<ProxyTexture> fallback_proxy = fallback;
+		if (fallback_proxy.is_valid()) {
+			fallback = fallback_proxy->get_base();
+		}
+		if (fallback.is_valid()) {
+			proxy->set_base(fallback);
+		}
 	}
+}
 
-	print_verbose("glTF: Total images: " + itos(state->images.size()));
+// Size an image is expected to take once decoded, from its header and size
+// limit. Images without a readable header count their encoded size.
+static int64_t _estimate_decoded_size(const GLTFImageSource &p_source, bool p_compressed) {
+	int width = 0;
+	int height = 0;
+	if (!p_source.is_ktx2 && p_source.data.size()) {
+		PoolByteArray::Read data_read = p_source.data.read();
+		_read_image_header_size(data_read.ptr() + p_source.offset, p_source.size, width, height);
+	}
+	if (width <= 0 || height <= 0) {
+		return p_source.size;
+	}
+	const int max_side = MAX(width, height);
+	const double scale = (p_source.max_size > 0 && max_side > p_source.max_size) ? (double)p_source.max_size / max_side : 1.0;
+	const int64_t w = MAX((int64_t)(width * scale), (int64_t)1);
+	const int64_t h = MAX((int64_t)(height * scale), (int64_t)1);
+	return w * h * (p_compressed ? 1 : 4) * 4 / 3;
+}
 
-	return OK;
+int GLTFDocument::prefetch_images(Ref<GLTFState> state, int64_t p_budget) {
+	// Images are decoded one batch of workers at a time. Each image is only
+	// added while its estimated size still fits in the budget, the estimates
+	// are replaced by the real sizes once a batch is decoded.
+	const int batch_size = state->worker_thread_count > 0 ? state->worker_thread_count : ThreadWorkPool::get_default_thread_count();
+	int64_t used = 0;
+	int decoded = 0;
+	std::vector<int> batch;
+	for (size_t i = 0; i < state->image_sources.size(); i++) {
+		const GLTFImageSource &source = state->image_sources[i];
+		if (source.decoded) {
+			used += source.decoded_size;
+		}
+	}
+	int64_t planned = used;
+	for (size_t i = 0; i < state->image_sources.size(); i++) {
+		const GLTFImageSource &source = state->image_sources[i];
+		if (source.err == ERR_SKIP || source.decoded || source.fallback_only) {
+			continue;
+		}
+		const int64_t estimate = _estimate_decoded_size(source, state->compress_textures);
+		if (planned + estimate > p_budget) {
+			break;
+		}
+		planned += estimate;
+		batch.push_back(i);
+		if ((int)batch.size() < batch_size) {
+			continue;
+		}
+		_decode_images(state, batch);
+		for (size_t batch_i = 0; batch_i < batch.size(); batch_i++) {
+			used += state->image_sources[batch[batch_i]].decoded_size;
+		}
+		planned = used;
+		decoded += batch.size();
+		batch.clear();
+	}
+	if (!batch.empty()) {
+		_decode_images(state, batch);
+		decoded += batch.size();
+	}
+	return decoded;
+}
+
+void GLTFDocument::materialize_images(Ref<GLTFState> state, PoolIntArray p_images) {
+	std::vector<int> images;
+	PoolIntArray::Read r = p_images.read();
+	for (int i = 0; i < p_images.size(); i++) {
+		ERR_CONTINUE(r[i] < 0 || r[i] >= (int)state->image_sources.size());
+		images.push_back(r[i]);
+	}
+	_decode_images(state, images);
+}
+
+static void _collect_material_textures(Ref<Material> p_material, Set<Texture *> &r_textures) {
+	Ref<SpatialMaterial> material = p_material;
+	if (material.is_null()) {
+		return;
+	}
+	for (int i = 0; i < SpatialMaterial::TEXTURE_MAX; i++) {
+		Ref<Texture> texture = material->get_texture(i);
+		if (texture.is_valid()) {
+			r_textures.insert(texture.ptr());
+		}
+	}
+}
+
+static void _collect_mesh_textures(Ref<Mesh> p_mesh, Set<Texture *> &r_textures) {
+	if (p_mesh.is_null()) {
+		return;
+	}
+	for (int i = 0; i < p_mesh->get_surface_count(); i++) {
+		_collect_material_textures(p_mesh->surface_get_material(i), r_textures);
+	}
+}
+
+static void _collect_scene_textures(Node *p_node, Set<Texture *> &r_textures) {
+	MeshInstance *mi = Object::cast_to<MeshInstance>(p_node);
+	if (mi) {
+		_collect_mesh_textures(mi->get_mesh(), r_textures);
+		_collect_material_textures(mi->get_material_override(), r_textures);
+		for (int i = 0; i < mi->get_surface_material_count(); i++) {
+			_collect_material_textures(mi->get_surface_material(i), r_textures);
+		}
+	}
+	MultiMeshInstance *mmi = Object::cast_to<MultiMeshInstance>(p_node);
+	if (mmi && mmi->get_multimesh().is_valid()) {
+		_collect_mesh_textures(mmi->get_multimesh()->get_mesh(), r_textures);
+		_collect_material_textures(mmi->get_material_override(), r_textures);
+	}
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_collect_scene_textures(p_node->get_child(i), r_textures);
+	}
+}
+
+void GLTFDocument::_materialize_scene_images(Ref<GLTFState> state, Node *scene_root) {
+	Set<Texture *> used_textures;
+	_collect_scene_textures(scene_root, used_textures);
+
+	std::vector<int> images;
+	for (int i = 0; i < state->images.size(); i++) {
+		if (state->images[i].is_valid() && used_textures.has(state->images[i].ptr())) {
+			images.push_back(i);
+		}
+	}
+	_decode_images(state, images);
 }
 
 Error GLTFDocument::_serialize_textures(Ref<GLTFState> state) {
@@ -3349,6 +6034,28 @@ Error GLTFDocument::_serialize_textures(Ref<GLTFState> state) {
 	return OK;
 }
 
+std::vector<GLTFImageIndex> GLTFDocument::_get_texture_image_sources(const Dictionary &p_texture) {
+	// Extension images first, in order of preference, then the core source.
+	static const char *SOURCE_EXTENSIONS[] = { "KHR_texture_basisu", "EXT_texture_webp" };
+	std::vector<GLTFImageIndex> images;
+	if (p_texture.has("extensions")) {
+		const Dictionary &extensions = p_texture["extensions"];
+		for (size_t i = 0; i < sizeof(SOURCE_EXTENSIONS) / sizeof(SOURCE_EXTENSIONS[0]); i++) {
+			if (!extensions.has(SOURCE_EXTENSIONS[i])) {
+				continue;
+			}
+			const Dictionary &extension = extensions[SOURCE_EXTENSIONS[i]];
+			if (extension.has("source")) {
+				images.push_back(extension["source"]);
+			}
+		}
+	}
+	if (p_texture.has("source")) {
+		images.push_back(p_texture["source"]);
+	}
+	return images;
+}
+
 Error GLTFDocument::_parse_textures(Ref<GLTFState> state) {
 	if (!state->json.has("textures")) {
 		return OK;
@@ -3358,11 +6065,34 @@ Error GLTFDocument::_parse_textures(Ref<GLTFState> state) {
 	for (GLTFTextureIndex i = 0; i < textures.size(); i++) {
 		const Dictionary &d = textures[i];
 
-		ERR_FAIL_COND_V(!d.has("source"), ERR_PARSE_ERROR);
+		// KHR_texture_basisu and EXT_texture_webp point at a KTX2 or WebP
+		// image, "source" is the optional PNG/JPEG fallback used when that
+		// image couldn't be loaded. Basis Universal payloads are never
+		// transcoded, only KTX2 in a raw GPU format is used directly.
+		// Lazy images aren't decoded yet, a failing one gets its fallback's
+		// texture once it is.
+		const std::vector<GLTFImageIndex> images = _get_texture_image_sources(d);
+		ERR_FAIL_COND_V(images.empty(), ERR_PARSE_ERROR);
+
+		GLTFImageIndex src_image = images.front();
+		for (size_t image_i = 0; image_i < images.size(); image_i++) {
+			const GLTFImageIndex image = images[image_i];
+			if (image < 0 || image >= (int)state->image_sources.size()) {
+				continue;
+			}
+			if (!state->lazy_textures && state->image_sources[image].err == OK && !state->image_sources[image].decoded) {
+				// A fallback whose primary image had no data to fail on.
+				_decode_images(state, std::vector<int>(1, image));
+			}
+			if (state->image_sources[image].err == OK) {
+				src_image = image;
+				break;
+			}
+		}
 
 		Ref<GLTFTexture> t;
 		t = GLTFTexture_class->new_();
-		t->set_src_image(d["source"]);
+		t->set_src_image(src_image);
 		state->textures.push_back(t);
 	}
 
@@ -3391,6 +6121,16 @@ Ref<Texture> GLTFDocument::_get_texture(Ref<GLTFState> state, const GLTFTextureI
 	return state->images[image];
 }
 
+Ref<Texture> GLTFDocument::_get_materialized_texture(Ref<GLTFState> state, const GLTFTextureIndex p_texture) {
+	// For callers that need the image data right away, e.g. texture conversion.
+	ERR_FAIL_INDEX_V(p_texture, state->textures.size(), Ref<Texture>());
+	const GLTFImageIndex image = state->textures[p_texture]->get_src_image();
+	if (image >= 0 && image < (int)state->image_sources.size()) {
+		_decode_images(state, std::vector<int>(1, image));
+	}
+	return _get_texture(state, p_texture);
+}
+
 Error GLTFDocument::_serialize_materials(Ref<GLTFState> state) {
 	Array materials;
 	for (int32_t i = 0; i < state->materials.size(); i++) {
@@ -3630,30 +6370,195 @@ Error GLTFDocument::_serialize_materials(Ref<GLTFState> state) {
 				emission_texture->set_name(material->get_name() + "_emission");
 				gltf_texture_index = _set_texture(state, emission_texture);
 			}
-
-			if (gltf_texture_index != -1) {
-				et["index"] = gltf_texture_index;
-				d["emissiveTexture"] = et;
+
+			if (gltf_texture_index != -1) {
+				et["index"] = gltf_texture_index;
+				d["emissiveTexture"] = et;
+			}
+		}
+		const bool ds = material->get_cull_mode() == SpatialMaterial::CULL_DISABLED;
+		if (ds) {
+			d["doubleSided"] = ds;
+		}
+		if (material->get_feature(SpatialMaterial::FEATURE_TRANSPARENT)) {
+			if (material->get_flag(SpatialMaterial::FLAG_USE_ALPHA_SCISSOR)) {
+				d["alphaMode"] = "MASK";
+				d["alphaCutoff"] = material->get_alpha_scissor_threshold();
+			} else {
+				d["alphaMode"] = "BLEND";
+			}
+		}
+		materials.push_back(d);
+	}
+	state->json["materials"] = materials;
+	print_verbose("Total materials: " + itos(state->materials.size()));
+
+	return OK;
+}
+
+// Properties that make up a material's parameters: everything stored except
+// the resource's own identity.
+static bool _is_material_parameter(const Dictionary &p_property) {
+	if (!((int)p_property["usage"] & GlobalConstants::PROPERTY_USAGE_STORAGE)) {
+		return false;
+	}
+	const String name = p_property["name"];
+	return name != "resource_name" && name != "resource_path" && name != "resource_local_to_scene" && name != "script";
+}
+
+// Hashes the raw bytes of numeric values, their string form would round
+// floats and let slightly different colors or factors collide.
+static uint64_t _hash_material_value(const Variant &p_value, uint64_t p_hash) {
+	const uint64_t hash = gltf_hash_int(p_value.get_type(), p_hash);
+	switch (p_value.get_type()) {
+		case Variant::BOOL:
+		case Variant::INT: {
+			return gltf_hash_int((int64_t)p_value, hash);
+		}
+		case Variant::REAL: {
+			const double value = p_value;
+			return gltf_hash_bytes((const uint8_t *)&value, sizeof(value), hash);
+		}
+		case Variant::COLOR: {
+			const Color color = p_value;
+			const float components[4] = { color.r, color.g, color.b, color.a };
+			return gltf_hash_bytes((const uint8_t *)components, sizeof(components), hash);
+		}
+		case Variant::VECTOR2: {
+			const Vector2 vector = p_value;
+			const real_t components[2] = { vector.x, vector.y };
+			return gltf_hash_bytes((const uint8_t *)components, sizeof(components), hash);
+		}
+		case Variant::VECTOR3: {
+			const Vector3 vector = p_value;
+			const real_t components[3] = { vector.x, vector.y, vector.z };
+			return gltf_hash_bytes((const uint8_t *)components, sizeof(components), hash);
+		}
+		default: {
+			return gltf_hash_int(String(p_value).hash(), hash);
+		}
+	}
+}
+
+uint64_t GLTFDocument::_hash_material(Ref<Material> p_material, const std::map<const Object *, uint64_t> &p_texture_keys) {
+	// Equally configured materials from different files share a key.
+	uint64_t hash = gltf_hash_bytes((const uint8_t *)"material", 8);
+	const Array properties = p_material->get_property_list();
+	for (int i = 0; i < properties.size(); i++) {
+		const Dictionary property = properties[i];
+		if (!_is_material_parameter(property)) {
+			continue;
+		}
+		const String name = property["name"];
+		const Variant value = p_material->get(name);
+		hash = gltf_hash_int(name.hash(), hash);
+		if (value.get_type() == Variant::OBJECT) {
+			Object *object = value;
+			std::map<const Object *, uint64_t>::const_iterator it = p_texture_keys.find(object);
+			if (it != p_texture_keys.end()) {
+				hash = gltf_hash_int(it->second, hash);
+			} else {
+				hash = gltf_hash_int(object ? object->get_instance_id() : 0, hash);
+			}
+		} else {
+			hash = _hash_material_value(value, hash);
+		}
+	}
+	return hash;
+}
+
+bool GLTFDocument::_materials_equal(Ref<Material> p_a, Ref<Material> p_b, const std::map<const Object *, uint64_t> &p_texture_keys) {
+	// Confirms a hash match: every parameter is compared, textures by their
+	// content key when both have one.
+	if (p_a == p_b) {
+		return true;
+	}
+	if (p_a->get_class() != p_b->get_class()) {
+		return false;
+	}
+	const Array properties = p_a->get_property_list();
+	for (int i = 0; i < properties.size(); i++) {
+		const Dictionary property = properties[i];
+		if (!_is_material_parameter(property)) {
+			continue;
+		}
+		const String name = property["name"];
+		const Variant value_a = p_a->get(name);
+		const Variant value_b = p_b->get(name);
+		if (value_a.get_type() != value_b.get_type()) {
+			return false;
+		}
+		if (value_a.get_type() == Variant::OBJECT) {
+			const Object *object_a = value_a;
+			const Object *object_b = value_b;
+			if (object_a == object_b) {
+				continue;
+			}
+			std::map<const Object *, uint64_t>::const_iterator it_a = p_texture_keys.find(object_a);
+			std::map<const Object *, uint64_t>::const_iterator it_b = p_texture_keys.find(object_b);
+			if (it_a == p_texture_keys.end() || it_b == p_texture_keys.end() || it_a->second != it_b->second) {
+				return false;
 			}
+		} else if (!(value_a == value_b)) {
+			return false;
 		}
-		const bool ds = material->get_cull_mode() == SpatialMaterial::CULL_DISABLED;
-		if (ds) {
-			d["doubleSided"] = ds;
+	}
+	return true;
+}
+
+Ref<Material> GLTFDocument::_canonicalize_material(Ref<GLTFState> state, Ref<Material> p_material) {
+	// Materials holding lazy proxies are never shared with other imports,
+	// another import's proxies are never materialized by this one.
+	const bool share_materials = state->share_resources && !state->lazy_textures;
+	if (p_material.is_null() || (!state->deduplicate_materials && !share_materials)) {
+		return p_material;
+	}
+	const uint64_t key = _hash_material(p_material, state->material_texture_keys);
+	typedef std::multimap<uint64_t, Ref<Material>>::iterator CanonicalIterator;
+	const std::pair<CanonicalIterator, CanonicalIterator> range = state->canonical_materials.equal_range(key);
+	for (CanonicalIterator it = range.first; it != range.second; ++it) {
+		if (_materials_equal(it->second, p_material, state->material_texture_keys)) {
+			return it->second;
 		}
-		if (material->get_feature(SpatialMaterial::FEATURE_TRANSPARENT)) {
-			if (material->get_flag(SpatialMaterial::FLAG_USE_ALPHA_SCISSOR)) {
-				d["alphaMode"] = "MASK";
-				d["alphaCutoff"] = material->get_alpha_scissor_threshold();
-			} else {
-				d["alphaMode"] = "BLEND";
-			}
+	}
+	Ref<Material> material = p_material;
+	if (share_materials && range.first == range.second) {
+		// A registry material's textures belong to its own import, so they
+		// only match textures shared through the registry as well.
+		Ref<Material> shared = GLTFResourceRegistry::find("materials", key);
+		if (shared.is_valid() && _materials_equal(shared, p_material, state->material_texture_keys)) {
+			material = shared;
+		} else if (shared.is_null()) {
+			GLTFResourceRegistry::add(key, material);
 		}
-		materials.push_back(d);
 	}
-	state->json["materials"] = materials;
-	print_verbose("Total materials: " + itos(state->materials.size()));
+	state->canonical_materials.insert(std::make_pair(key, material));
+	return material;
+}
 
-	return OK;
+Ref<SpatialMaterial> GLTFDocument::_get_vertex_color_material(Ref<GLTFState> state, Ref<SpatialMaterial> p_material) {
+	// Vertex colored primitives get a variant of their material instead of
+	// changing a material other primitives may share.
+	if (p_material.is_valid() && p_material->get_flag(SpatialMaterial::FLAG_ALBEDO_FROM_VERTEX_COLOR)) {
+		return p_material;
+	}
+	std::map<const Object *, Ref<Material>>::iterator it = state->vertex_color_materials.find(p_material.ptr());
+	if (it != state->vertex_color_materials.end()) {
+		return it->second;
+	}
+	Ref<SpatialMaterial> variant;
+	if (p_material.is_valid()) {
+		variant = p_material->duplicate();
+	} else {
+		variant.instance();
+	}
+	variant->set_flag(SpatialMaterial::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+	Ref<SpatialMaterial> material = _canonicalize_material(state, variant);
+	if (material == variant) {
+		state->vertex_color_variants++;
+	}
+	state->vertex_color_materials[p_material.ptr()] = material;
+	return material;
 }
 
 Error GLTFDocument::_parse_materials(Ref<GLTFState> state) {
@@ -3661,6 +6566,19 @@ Error GLTFDocument::_parse_materials(Ref<GLTFState> state) {
 		return OK;
 	}
 
+	// Textures are keyed by their image content, which is stable across
+	// imports even when lazy textures are still empty proxies.
+	state->canonical_materials.clear();
+	state->material_texture_keys.clear();
+	state->material_uv_transforms.clear();
+	uint64_t spec_gloss_usec = 0;
+	// Images without a key are hashed by their texture's identity instead.
+	for (int i = 0; i < state->images.size() && i < (int)state->image_sources.size(); i++) {
+		if (state->images[i].is_valid() && state->image_sources[i].key != 0) {
+			state->material_texture_keys[state->images[i].ptr()] = state->image_sources[i].key;
+		}
+	}
+
 	const Array &materials = state->json["materials"];
 	for (GLTFMaterialIndex i = 0; i < materials.size(); i++) {
 		const Dictionary &d = materials[i];
@@ -3687,7 +6605,7 @@ Error GLTFDocument::_parse_materials(Ref<GLTFState> state) {
 			if (sgm.has("diffuseTexture")) {
 				const Dictionary &diffuse_texture_dict = sgm["diffuseTexture"];
 				if (diffuse_texture_dict.has("index")) {
-					Ref<Texture> diffuse_texture = _get_texture(state, diffuse_texture_dict["index"]);
+					Ref<Texture> diffuse_texture = _get_materialized_texture(state, diffuse_texture_dict["index"]);
 					if (diffuse_texture.is_valid()) {
 						spec_gloss->diffuse_img = diffuse_texture->get_data();
 						material->set_texture(SpatialMaterial::TEXTURE_ALBEDO, diffuse_texture);
@@ -3715,13 +6633,15 @@ Error GLTFDocument::_parse_materials(Ref<GLTFState> state) {
 			if (sgm.has("specularGlossinessTexture")) {
 				const Dictionary &spec_gloss_texture = sgm["specularGlossinessTexture"];
 				if (spec_gloss_texture.has("index")) {
-					const Ref<Texture> orig_texture = _get_texture(state, spec_gloss_texture["index"]);
+					const Ref<Texture> orig_texture = _get_materialized_texture(state, spec_gloss_texture["index"]);
 					if (orig_texture.is_valid()) {
 						spec_gloss->spec_gloss_img = orig_texture->get_data();
 					}
 				}
 			}
-			spec_gloss_to_rough_metal(spec_gloss, material);
+			const uint64_t spec_gloss_begin = OS::get_singleton()->get_ticks_usec();
+			spec_gloss_to_rough_metal(spec_gloss, material, state->worker_thread_count);
+			spec_gloss_usec += OS::get_singleton()->get_ticks_usec() - spec_gloss_begin;
 
 		} else if (d.has("pbrMetallicRoughness")) {
 			const Dictionary &mr = d["pbrMetallicRoughness"];
@@ -3740,7 +6660,14 @@ Error GLTFDocument::_parse_materials(Ref<GLTFState> state) {
 				if (!mr.has("baseColorFactor")) {
 					material->set_albedo(Color(1, 1, 1));
 				}
-				_set_texture_transform_uv1(bct, material);
+				// A baked transform leaves the material free to be shared
+				// with the same material at a different tiling.
+				Transform2D uv_transform;
+				if (state->bake_texture_transforms && _get_texture_transform(bct, uv_transform)) {
+					state->material_uv_transforms[i] = uv_transform;
+				} else {
+					_set_texture_transform_uv1(bct, material);
+				}
 			}
 
 			if (mr.has("metallicFactor")) {
@@ -3831,14 +6758,61 @@ Error GLTFDocument::_parse_materials(Ref<GLTFState> state) {
 				}
 			}
 		}
-		state->materials.push_back(material);
+		state->materials.push_back(_canonicalize_material(state, material));
+	}
+	if (state->share_resources) {
+		state->import_stats["registry"] = GLTFResourceRegistry::get_stats();
 	}
+	std::set<const Object *> unique_materials;
+	for (int material_i = 0; material_i < state->materials.size(); material_i++) {
+		unique_materials.insert(state->materials[material_i].ptr());
+	}
+	Dictionary stats;
+	stats["count"] = materials.size();
+	stats["unique"] = (int)unique_materials.size();
+	stats["vertex_color_variants"] = 0;
+	stats["baked_transforms"] = (int)state->material_uv_transforms.size();
+	stats["spec_gloss_msec"] = (real_t)(spec_gloss_usec / 1000.0);
+	state->import_stats["materials"] = stats;
 
 	print_verbose("Total materials: " + itos(state->materials.size()));
 
 	return OK;
 }
 
+bool GLTFDocument::_get_texture_transform(const Dictionary &p_texture_info, Transform2D &r_transform) {
+	// KHR_texture_transform maps a UV to offset + rotation * (scale * UV).
+	// Transforms that switch to another UV set are left to the material.
+	if (!p_texture_info.has("extensions")) {
+		return false;
+	}
+	const Dictionary &extensions = p_texture_info["extensions"];
+	if (!extensions.has("KHR_texture_transform")) {
+		return false;
+	}
+	const Dictionary &texture_transform = extensions["KHR_texture_transform"];
+	if (texture_transform.has("texCoord")) {
+		return false;
+	}
+	Vector2 offset = Vector2(0.0f, 0.0f);
+	if (texture_transform.has("offset")) {
+		const Array &offset_arr = texture_transform["offset"];
+		ERR_FAIL_COND_V(offset_arr.size() != 2, false);
+		offset = Vector2(offset_arr[0], offset_arr[1]);
+	}
+	Vector2 scale = Vector2(1.0f, 1.0f);
+	if (texture_transform.has("scale")) {
+		const Array &scale_arr = texture_transform["scale"];
+		ERR_FAIL_COND_V(scale_arr.size() != 2, false);
+		scale = Vector2(scale_arr[0], scale_arr[1]);
+	}
+	const real_t rotation = texture_transform.has("rotation") ? (real_t)texture_transform["rotation"] : 0.0f;
+	const real_t c = Math::cos(rotation);
+	const real_t s = Math::sin(rotation);
+	r_transform = Transform2D(scale.x * c, -scale.x * s, scale.y * s, scale.y * c, offset.x, offset.y);
+	return true;
+}
+
 void GLTFDocument::_set_texture_transform_uv1(const Dictionary &d, Ref<SpatialMaterial> material) {
 	if (d.has("extensions")) {
 		const Dictionary &extensions = d["extensions"];
@@ -3859,60 +6833,111 @@ void GLTFDocument::_set_texture_transform_uv1(const Dictionary &d, Ref<SpatialMa
 	}
 }
 
-void GLTFDocument::spec_gloss_to_rough_metal(Ref<GLTFSpecGloss> r_spec_gloss, Ref<SpatialMaterial> p_material) {
+// Linear to sRGB lookup resolution, fine enough to stay within one 8-bit step.
+static const int SRGB_TABLE_SIZE = 4096;
+
+void GLTFDocument::spec_gloss_to_rough_metal(Ref<GLTFSpecGloss> r_spec_gloss, Ref<SpatialMaterial> p_material, int p_threads) {
 	if (r_spec_gloss->spec_gloss_img.is_null()) {
 		return;
 	}
 	if (r_spec_gloss->diffuse_img.is_null()) {
 		return;
 	}
-	Ref<Image> rm_img;
-	rm_img.instance();
-	bool has_roughness = false;
-	bool has_metal = false;
 	p_material->set_roughness(1.0f);
 	p_material->set_metallic(1.0f);
-	rm_img->create(r_spec_gloss->spec_gloss_img->get_width(), r_spec_gloss->spec_gloss_img->get_height(), false, Image::FORMAT_RGBA8);
-	rm_img->lock();
-	r_spec_gloss->spec_gloss_img->decompress();
-	if (r_spec_gloss->diffuse_img.is_valid()) {
-		r_spec_gloss->diffuse_img->decompress();
-		r_spec_gloss->diffuse_img->resize(r_spec_gloss->spec_gloss_img->get_width(), r_spec_gloss->spec_gloss_img->get_height(), Image::INTERPOLATE_LANCZOS);
-		r_spec_gloss->spec_gloss_img->resize(r_spec_gloss->diffuse_img->get_width(), r_spec_gloss->diffuse_img->get_height(), Image::INTERPOLATE_LANCZOS);
-	}
-	for (int32_t y = 0; y < r_spec_gloss->spec_gloss_img->get_height(); y++) {
-		for (int32_t x = 0; x < r_spec_gloss->spec_gloss_img->get_width(); x++) {
-			const Color specular_pixel = r_spec_gloss->spec_gloss_img->get_pixel(x, y).to_linear();
-			Color specular = Color(specular_pixel.r, specular_pixel.g, specular_pixel.b);
-			specular *= r_spec_gloss->specular_factor;
-			Color diffuse = Color(1.0f, 1.0f, 1.0f);
-			r_spec_gloss->diffuse_img->lock();
-			diffuse *= r_spec_gloss->diffuse_img->get_pixel(x, y).to_linear();
-			float metallic = 0.0f;
-			Color base_color;
-			spec_gloss_to_metal_base_color(specular, diffuse, base_color, metallic);
-			Color mr = Color(1.0f, 1.0f, 1.0f);
-			mr.g = specular_pixel.a;
-			mr.b = metallic;
-			if (!Math::is_equal_approx(mr.g, 1.0f)) {
-				has_roughness = true;
-			}
-			if (!Math::is_equal_approx(mr.b, 0.0f)) {
-				has_metal = true;
-			}
-			mr.g *= r_spec_gloss->gloss_factor;
-			mr.g = 1.0f - mr.g;
-			rm_img->set_pixel(x, y, mr);
-			r_spec_gloss->diffuse_img->set_pixel(x, y, Color_to_srgb(base_color));
-			r_spec_gloss->diffuse_img->unlock();
-		}
-	}
-	rm_img->unlock();
-	rm_img->generate_mipmaps();
-	r_spec_gloss->diffuse_img->generate_mipmaps();
+
+	// Works on the raw RGBA8 level 0 of both images, row by row on the worker
+	// threads, with table lookups instead of per pixel pow() calls.
+	Ref<Image> spec_gloss_img = r_spec_gloss->spec_gloss_img;
+	Ref<Image> diffuse_img = r_spec_gloss->diffuse_img;
+	spec_gloss_img->decompress();
+	spec_gloss_img->convert(Image::FORMAT_RGBA8);
+	diffuse_img->decompress();
+	diffuse_img->convert(Image::FORMAT_RGBA8);
+	const int width = spec_gloss_img->get_width();
+	const int height = spec_gloss_img->get_height();
+	if (diffuse_img->get_width() != width || diffuse_img->get_height() != height) {
+		diffuse_img->resize(width, height, Image::INTERPOLATE_LANCZOS);
+	}
+
+	static float to_linear_table[256];
+	static uint8_t to_srgb_table[SRGB_TABLE_SIZE];
+	static bool tables_ready = [] {
+		for (int i = 0; i < 256; i++) {
+			to_linear_table[i] = Color(i / 255.0f, 0.0f, 0.0f).to_linear().r;
+		}
+		for (int i = 0; i < SRGB_TABLE_SIZE; i++) {
+			const float srgb = Color_to_srgb(Color((float)i / (SRGB_TABLE_SIZE - 1), 0.0f, 0.0f)).r;
+			to_srgb_table[i] = uint8_t(CLAMP(srgb * 255.0f, 0.0f, 255.0f));
+		}
+		return true;
+	}();
+	(void)tables_ready;
+
+	const PoolByteArray spec_gloss_data = spec_gloss_img->get_data();
+	const PoolByteArray diffuse_data = diffuse_img->get_data();
+	PoolByteArray rm_data;
+	rm_data.resize(width * height * 4);
+	PoolByteArray base_color_data;
+	base_color_data.resize(width * height * 4);
+	std::vector<uint8_t> row_has_roughness(height, 0);
+	std::vector<uint8_t> row_has_metal(height, 0);
+	{
+		PoolByteArray::Read spec_gloss_read = spec_gloss_data.read();
+		PoolByteArray::Read diffuse_read = diffuse_data.read();
+		PoolByteArray::Write rm_write = rm_data.write();
+		PoolByteArray::Write base_color_write = base_color_data.write();
+		const uint8_t *spec_gloss_ptr = spec_gloss_read.ptr();
+		const uint8_t *diffuse_ptr = diffuse_read.ptr();
+		uint8_t *rm_ptr = rm_write.ptr();
+		uint8_t *base_color_ptr = base_color_write.ptr();
+		const Color specular_factor = r_spec_gloss->specular_factor;
+		const float gloss_factor = r_spec_gloss->gloss_factor;
+
+		ThreadWorkPool::do_work(height, p_threads, [&](int y) {
+			bool has_roughness = false;
+			bool has_metal = false;
+			const int row = y * width * 4;
+			for (int x = 0; x < width; x++) {
+				const uint8_t *sg = spec_gloss_ptr + row + x * 4;
+				const uint8_t *d = diffuse_ptr + row + x * 4;
+				const Color specular = Color(to_linear_table[sg[0]], to_linear_table[sg[1]], to_linear_table[sg[2]]) * specular_factor;
+				const Color diffuse = Color(to_linear_table[d[0]], to_linear_table[d[1]], to_linear_table[d[2]], d[3] / 255.0f);
+				float metallic = 0.0f;
+				Color base_color;
+				spec_gloss_to_metal_base_color(specular, diffuse, base_color, metallic);
+
+				const float gloss = sg[3] / 255.0f;
+				has_roughness = has_roughness || !Math::is_equal_approx(gloss, 1.0f);
+				has_metal = has_metal || !Math::is_equal_approx(metallic, 0.0f);
+				uint8_t *rm = rm_ptr + row + x * 4;
+				rm[0] = 255;
+				rm[1] = uint8_t(CLAMP((1.0f - gloss * gloss_factor) * 255.0f, 0.0f, 255.0f));
+				rm[2] = uint8_t(CLAMP(metallic * 255.0f, 0.0f, 255.0f));
+				rm[3] = 255;
+
+				uint8_t *out = base_color_ptr + row + x * 4;
+				out[0] = to_srgb_table[CLAMP((int)(base_color.r * (SRGB_TABLE_SIZE - 1) + 0.5f), 0, SRGB_TABLE_SIZE - 1)];
+				out[1] = to_srgb_table[CLAMP((int)(base_color.g * (SRGB_TABLE_SIZE - 1) + 0.5f), 0, SRGB_TABLE_SIZE - 1)];
+				out[2] = to_srgb_table[CLAMP((int)(base_color.b * (SRGB_TABLE_SIZE - 1) + 0.5f), 0, SRGB_TABLE_SIZE - 1)];
+				out[3] = d[3];
+			}
+			row_has_roughness[y] = has_roughness;
+			row_has_metal[y] = has_metal;
+		});
+	}
+	const bool has_roughness = std::find(row_has_roughness.begin(), row_has_roughness.end(), 1) != row_has_roughness.end();
+	const bool has_metal = std::find(row_has_metal.begin(), row_has_metal.end(), 1) != row_has_metal.end();
+
+	Ref<Image> rm_img;
+	rm_img.instance();
+	rm_img->create_from_data(width, height, false, Image::FORMAT_RGBA8, rm_data);
+	_generate_image_mipmaps(rm_img, false, p_threads);
+	diffuse_img->create_from_data(width, height, false, Image::FORMAT_RGBA8, base_color_data);
+	_generate_image_mipmaps(diffuse_img, true, p_threads);
 	Ref<ImageTexture> diffuse_image_texture;
 	diffuse_image_texture.instance();
-	diffuse_image_texture->create_from_image(r_spec_gloss->diffuse_img);
+	diffuse_image_texture->create_from_image(diffuse_img);
 	p_material->set_texture(SpatialMaterial::TEXTURE_ALBEDO, diffuse_image_texture);
 	Ref<ImageTexture> rm_image_texture;
 	rm_image_texture.instance();
@@ -5254,9 +8279,66 @@ Spatial *GLTFDocument::_generate_mesh_instance(Ref<GLTFState> state, Node *scene
 	for (int i = 0; i < mesh->get_blend_weights().size(); i++) {
 		mi->set("blend_shapes/" + mesh->get_mesh()->get_blend_shape_name(i), mesh->get_blend_weights()[i]);
 	}
+	_assign_mesh_lods(state, mi, node_index);
 	return mi;
 }
 
+bool GLTFDocument::_is_mesh_chunked(Ref<GLTFState> state, const GLTFNodeIndex node_index) {
+	// Skinned instances keep the whole mesh, chunks are not deformed.
+	Ref<GLTFNode> gltf_node = state->nodes[node_index];
+	return gltf_node->mesh >= 0 && gltf_node->mesh < state->meshes.size() && gltf_node->skin < 0 &&
+		   state->meshes[gltf_node->mesh]->get_chunks().size();
+}
+
+void GLTFDocument::_generate_mesh_chunks(Ref<GLTFState> state, Spatial *scene_parent, Spatial *scene_root, const GLTFNodeIndex node_index) {
+	Ref<GLTFNode> gltf_node = state->nodes[node_index];
+	const Array chunks = state->meshes[gltf_node->mesh]->get_chunks();
+	for (int chunk_i = 0; chunk_i < chunks.size(); chunk_i++) {
+		MeshInstance *mi = MeshInstance::_new();
+		mi->set_mesh(chunks[chunk_i]);
+		mi->set_name(gltf_node->get_name() + "_chunk" + itos(chunk_i));
+		scene_parent->add_child(mi);
+		mi->set_owner(scene_root);
+	}
+}
+
+void GLTFDocument::_assign_mesh_lods(Ref<GLTFState> state, MeshInstance *mi, const GLTFNodeIndex node_index) {
+	Ref<GLTFNode> gltf_node = state->nodes[node_index];
+	Ref<GLTFMesh> mesh = state->meshes[gltf_node->mesh];
+
+	Array lods;
+	PoolRealArray lod_distances;
+	if (gltf_node->lods.size()) {
+		// MSFT_lod chains authored in the file win over generated ones.
+		const real_t size = mesh->get_mesh()->get_aabb().get_longest_axis_size();
+		const real_t half_fov_tan = Math::tan(Math::deg2rad(LOD_REFERENCE_FOV) * 0.5f);
+		for (int i = 0; i < gltf_node->lods.size(); i++) {
+			const GLTFNodeIndex lod_i = gltf_node->lods[i];
+			ERR_CONTINUE(lod_i < 0 || lod_i >= state->nodes.size());
+			const GLTFMeshIndex lod_mesh_i = state->nodes[lod_i]->mesh;
+			ERR_CONTINUE(lod_mesh_i < 0 || lod_mesh_i >= state->meshes.size());
+			lods.push_back(state->meshes[lod_mesh_i]->get_mesh());
+			if (i < gltf_node->lod_screen_coverage.size() && gltf_node->lod_screen_coverage[i] > 0.0f) {
+				lod_distances.push_back(size / (2.0f * half_fov_tan * gltf_node->lod_screen_coverage[i]));
+			}
+		}
+		if (lod_distances.size() != lods.size()) {
+			lod_distances = PoolRealArray();
+		}
+	} else {
+		lods = mesh->get_lods();
+		lod_distances = mesh->get_lod_distances();
+	}
+	if (lods.empty()) {
+		return;
+	}
+
+	// Godot 3 has no automatic mesh LOD switching, the chain is stored on the
+	// instance for the game to swap in.
+	mi->set_meta("gltf_lods", lods);
+	mi->set_meta("gltf_lod_distances", lod_distances);
+}
+
 Spatial *GLTFDocument::_generate_light(Ref<GLTFState> state, Node *scene_parent, const GLTFNodeIndex node_index) {
 	Ref<GLTFNode> gltf_node = state->nodes[node_index];
 
@@ -5708,7 +8790,16 @@ void GLTFDocument::_generate_scene_node(Ref<GLTFState> state, Node *scene_parent
 	}
 
 	// We still have not managed to make a node
-	if (gltf_node->mesh >= 0) {
+	// MultiMeshInstance can't be skinned, skinned instanced meshes are imported once.
+	const bool is_instanced = gltf_node->mesh >= 0 && !gltf_node->instancing_attributes.empty();
+	if (is_instanced && gltf_node->skin >= 0) {
+		WARN_PRINT(str_format("glTF: Node index '{0}' uses EXT_mesh_gpu_instancing on a skinned mesh, which isn't supported. Importing a single instance.", node_index));
+	}
+	if (is_instanced && gltf_node->skin < 0) {
+		current_node = _generate_gpu_instanced_mesh(state, scene_parent, node_index);
+	} else if (_is_mesh_chunked(state, node_index)) {
+		current_node = _generate_spatial(state, scene_parent, node_index);
+	} else if (gltf_node->mesh >= 0) {
 		current_node = _generate_mesh_instance(state, scene_parent, node_index);
 	} else if (gltf_node->camera >= 0) {
 		current_node = _generate_camera(state, scene_parent, node_index);
@@ -5727,6 +8818,10 @@ void GLTFDocument::_generate_scene_node(Ref<GLTFState> state, Node *scene_parent
 
 	state->scene_nodes.insert(node_index, current_node);
 
+	if (_is_mesh_chunked(state, node_index)) {
+		_generate_mesh_chunks(state, current_node, scene_root, node_index);
+	}
+
 	for (int i = 0; i < gltf_node->children.size(); ++i) {
 		_generate_scene_node(state, current_node, scene_root, gltf_node->children[i]);
 	}
@@ -6293,6 +9388,8 @@ float GLTFDocument::get_max_component(const Color &p_color) {
 }
 
 void GLTFDocument::_process_mesh_instances(Ref<GLTFState> state, Node *scene_root) {
+	int split_meshes = 0;
+	SkinPaletteCache palette_cache;
 	for (GLTFNodeIndex node_i = 0; node_i < state->nodes.size(); ++node_i) {
 		Ref<GLTFNode> node = state->nodes[node_i];
 
@@ -6317,8 +9414,540 @@ void GLTFDocument::_process_mesh_instances(Ref<GLTFState> state, Node *scene_roo
 			mi->set_skin(state->skins.write[skin_i]->godot_skin);
 			mi->set_skeleton_path(mi->get_path_to(skeleton));
 			mi->set_transform(Transform());
+
+			// Nodes parented under the mesh would be freed along with it.
+			if (state->skin_palette_size > 0 && mi->get_child_count() == 0 &&
+					_split_skinned_mesh_by_palette(state, mi, skeleton, state->skins[skin_i]->godot_skin, palette_cache)) {
+				skeleton->remove_child(mi);
+				state->scene_nodes.erase(mi_element);
+				// Out of the tree a queued free may never run, delete it right away.
+				mi->free();
+				split_meshes++;
+			}
+		}
+	}
+
+	if (state->skin_palette_size > 0) {
+		state->import_stats["skin_palette_splits"] = split_meshes;
+	}
+}
+
+bool GLTFDocument::_split_skinned_mesh_by_palette(Ref<GLTFState> state, MeshInstance *mi, Skeleton *skeleton, Ref<Skin> skin, SkinPaletteCache &r_cache) {
+	Ref<ArrayMesh> mesh = mi->get_mesh();
+	if (mesh.is_null() || mesh->get_blend_shape_count() || mi->has_meta("gltf_lods")) {
+		return false;
+	}
+
+	// Instances of the same mesh and skin share their partitions.
+	const std::pair<const Object *, const Object *> cache_key(mesh.ptr(), skin.ptr());
+	SkinPaletteCache::iterator cached = r_cache.find(cache_key);
+	if (cached == r_cache.end()) {
+		cached = r_cache.insert(std::make_pair(cache_key, _build_skin_palette_partitions(state, mesh, skin))).first;
+	}
+	const std::vector<std::pair<Ref<ArrayMesh>, Ref<Skin>>> &parts = cached->second;
+	if (parts.empty()) {
+		return false;
+	}
+
+	Node *parent = mi->get_parent();
+	for (size_t part_i = 0; part_i < parts.size(); part_i++) {
+		MeshInstance *partition_mi = MeshInstance::_new();
+		partition_mi->set_mesh(parts[part_i].first);
+		partition_mi->set_name(String(mi->get_name()) + "_part" + itos(part_i));
+		parent->add_child(partition_mi);
+		partition_mi->set_owner(mi->get_owner());
+		partition_mi->set_skin(parts[part_i].second);
+		partition_mi->set_skeleton_path(partition_mi->get_path_to(skeleton));
+		partition_mi->set_transform(Transform());
+	}
+	return true;
+}
+
+std::vector<std::pair<Ref<ArrayMesh>, Ref<Skin>>> GLTFDocument::_build_skin_palette_partitions(Ref<GLTFState> state, Ref<ArrayMesh> mesh, Ref<Skin> skin) {
+	const int INFLUENCES = 4;
+	// A single triangle can reference up to 12 joints, smaller palettes
+	// cannot hold every triangle.
+	const int palette_size = MAX(state->skin_palette_size, 3 * INFLUENCES);
+	std::vector<std::pair<Ref<ArrayMesh>, Ref<Skin>>> parts;
+
+	struct Partition {
+		int surface = 0;
+		std::vector<int> triangles;
+		std::vector<int> palette;
+	};
+	std::vector<Partition> partitions;
+	std::vector<Array> surface_arrays;
+
+	for (int surface_i = 0; surface_i < mesh->get_surface_count(); surface_i++) {
+		const Array arrays = mesh->surface_get_arrays(surface_i);
+		surface_arrays.push_back(arrays);
+		if (mesh->surface_get_primitive_type(surface_i) != Mesh::PRIMITIVE_TRIANGLES ||
+				arrays[Mesh::ARRAY_INDEX].get_type() != Variant::POOL_INT_ARRAY ||
+				arrays[Mesh::ARRAY_BONES].get_type() != Variant::POOL_INT_ARRAY) {
+			return parts;
+		}
+		const PoolIntArray indices = arrays[Mesh::ARRAY_INDEX];
+		const PoolIntArray bones = arrays[Mesh::ARRAY_BONES];
+		const PoolRealArray weights = arrays[Mesh::ARRAY_WEIGHTS];
+		const int vertex_count = ((PoolVector3Array)arrays[Mesh::ARRAY_VERTEX]).size();
+		if (bones.size() != vertex_count * INFLUENCES || weights.size() != vertex_count * INFLUENCES) {
+			return parts;
+		}
+		PoolIntArray::Read index_read = indices.read();
+		PoolIntArray::Read bone_read = bones.read();
+		PoolRealArray::Read weight_read = weights.read();
+
+		// Greedy passes over the triangles in file order, which tends to keep
+		// neighbouring triangles (and their joints) together. Triangles that
+		// do not fit are left for the next partition.
+		std::vector<int> pending(indices.size() / 3);
+		for (size_t i = 0; i < pending.size(); i++) {
+			pending[i] = i;
+		}
+		std::vector<int> palette_slot(skin->get_bind_count(), -1);
+		while (!pending.empty()) {
+			Partition partition;
+			partition.surface = surface_i;
+			std::vector<int> deferred;
+			for (size_t pending_i = 0; pending_i < pending.size(); pending_i++) {
+				const int tri = pending[pending_i];
+				int new_joints[3 * INFLUENCES];
+				int new_count = 0;
+				bool valid = true;
+				for (int corner = 0; corner < 3 && valid; corner++) {
+					const int vertex = index_read[tri * 3 + corner];
+					valid = vertex >= 0 && vertex < vertex_count;
+					for (int k = 0; valid && k < INFLUENCES; k++) {
+						const int joint = bone_read[vertex * INFLUENCES + k];
+						if (!(weight_read[vertex * INFLUENCES + k] > 0.0f)) {
+							continue;
+						}
+						valid = joint >= 0 && joint < (int)palette_slot.size();
+						if (valid && palette_slot[joint] < 0 && std::find(new_joints, new_joints + new_count, joint) == new_joints + new_count) {
+							new_joints[new_count++] = joint;
+						}
+					}
+				}
+				ERR_CONTINUE(!valid);
+				if ((int)partition.palette.size() + new_count > palette_size) {
+					deferred.push_back(tri);
+					continue;
+				}
+				for (int i = 0; i < new_count; i++) {
+					palette_slot[new_joints[i]] = partition.palette.size();
+					partition.palette.push_back(new_joints[i]);
+				}
+				partition.triangles.push_back(tri);
+			}
+			for (size_t i = 0; i < partition.palette.size(); i++) {
+				palette_slot[partition.palette[i]] = -1;
+			}
+			if (partition.triangles.empty()) {
+				break;
+			}
+			partitions.push_back(partition);
+			pending.swap(deferred);
+		}
+	}
+	if (partitions.size() <= (size_t)mesh->get_surface_count()) {
+		// Every surface already fits into one palette.
+		return parts;
+	}
+
+	for (size_t partition_i = 0; partition_i < partitions.size(); partition_i++) {
+		const Partition &partition = partitions[partition_i];
+		const Array &arrays = surface_arrays[partition.surface];
+		const PoolIntArray indices = arrays[Mesh::ARRAY_INDEX];
+		PoolIntArray::Read index_read = indices.read();
+
+		std::vector<int> remap(((PoolVector3Array)arrays[Mesh::ARRAY_VERTEX]).size(), -1);
+		std::vector<int> vertices;
+		PoolIntArray partition_indices;
+		partition_indices.resize(partition.triangles.size() * 3);
+		{
+			PoolIntArray::Write w = partition_indices.write();
+			for (size_t i = 0; i < partition.triangles.size(); i++) {
+				for (int corner = 0; corner < 3; corner++) {
+					const int vertex = index_read[partition.triangles[i] * 3 + corner];
+					if (remap[vertex] < 0) {
+						remap[vertex] = vertices.size();
+						vertices.push_back(vertex);
+					}
+					w[i * 3 + corner] = remap[vertex];
+				}
+			}
+		}
+		Array partition_arrays = _gather_surface_vertices(arrays, vertices);
+		partition_arrays[Mesh::ARRAY_INDEX] = partition_indices;
+
+		// Bone indices now point into the partition's own palette.
+		std::vector<int> palette_slot(skin->get_bind_count(), 0);
+		for (size_t i = 0; i < partition.palette.size(); i++) {
+			palette_slot[partition.palette[i]] = i;
+		}
+		PoolIntArray bones = partition_arrays[Mesh::ARRAY_BONES];
+		{
+			const int bone_count = bones.size();
+			PoolIntArray::Write w = bones.write();
+			for (int i = 0; i < bone_count; i++) {
+				// Unweighted influences may reference any joint, point them at slot 0.
+				w[i] = (w[i] >= 0 && w[i] < (int)palette_slot.size()) ? palette_slot[w[i]] : 0;
+			}
+		}
+		partition_arrays[Mesh::ARRAY_BONES] = bones;
+
+		Ref<Skin> partition_skin;
+		partition_skin.instance();
+		for (size_t i = 0; i < partition.palette.size(); i++) {
+			const int bind = partition.palette[i];
+			partition_skin->add_bind(skin->get_bind_bone(bind), skin->get_bind_pose(bind));
+			partition_skin->set_bind_name(i, skin->get_bind_name(bind));
+		}
+		partition_skin->set_name(skin->get_name() + "_part" + itos(partition_i));
+
+		Ref<ArrayMesh> partition_mesh;
+		partition_mesh.instance();
+		partition_mesh->set_name(mesh->get_name() + "_part" + itos(partition_i));
+		partition_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, partition_arrays);
+		partition_mesh->surface_set_material(0, mesh->surface_get_material(partition.surface));
+
+		parts.push_back(std::make_pair(partition_mesh, partition_skin));
+	}
+	return parts;
+}
+
+Spatial *GLTFDocument::_generate_gpu_instanced_mesh(Ref<GLTFState> state, Node *scene_parent, const GLTFNodeIndex node_index) {
+	Ref<GLTFNode> gltf_node = state->nodes[node_index];
+
+	ERR_FAIL_INDEX_V(gltf_node->mesh, state->meshes.size(), nullptr);
+	print_verbose("glTF: Creating instanced mesh for: " + gltf_node->get_name());
+
+	PoolVector3Array translations;
+	Vector<Quat> rotations;
+	PoolVector3Array scales;
+	const Dictionary &attributes = gltf_node->instancing_attributes;
+	if (attributes.has("TRANSLATION")) {
+		_decode_accessor_as_vec3(state, attributes["TRANSLATION"], false, translations);
+	}
+	if (attributes.has("ROTATION")) {
+		_decode_accessor_as_quat(state, attributes["ROTATION"], false, rotations);
+	}
+	if (attributes.has("SCALE")) {
+		_decode_accessor_as_vec3(state, attributes["SCALE"], false, scales);
+	}
+	const int instance_count = MAX(translations.size(), MAX(rotations.size(), scales.size()));
+	ERR_FAIL_COND_V_MSG((translations.size() && translations.size() != instance_count) || (rotations.size() && rotations.size() != instance_count) || (scales.size() && scales.size() != instance_count),
+			_generate_mesh_instance(state, scene_parent, node_index), "glTF: EXT_mesh_gpu_instancing attribute counts do not match.");
+
+	Ref<MultiMesh> multi_mesh;
+	multi_mesh.instance();
+	multi_mesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+	multi_mesh->set_mesh(state->meshes[gltf_node->mesh]->get_mesh());
+	multi_mesh->set_instance_count(instance_count);
+	for (int i = 0; i < instance_count; i++) {
+		const Quat rotation = rotations.size() ? rotations[i] : Quat();
+		const Vector3 scale = scales.size() ? scales[i] : Vector3(1, 1, 1);
+		Transform xform;
+		xform.basis = Basis_set_quat_scale(rotation, scale);
+		xform.origin = translations.size() ? translations[i] : Vector3();
+		multi_mesh->set_instance_transform(i, xform);
+	}
+
+	MultiMeshInstance *mmi = MultiMeshInstance::_new();
+	mmi->set_multimesh(multi_mesh);
+	return mmi;
+}
+
+void GLTFDocument::_instance_repeated_meshes(Ref<GLTFState> state, Node *scene_root) {
+	struct InstanceGroup {
+		Node *parent = nullptr;
+		Ref<Mesh> mesh;
+		std::vector<MeshInstance *> instances;
+		std::vector<GLTFNodeIndex> node_indices;
+	};
+
+	const std::vector<bool> animated = _get_animated_nodes(state);
+
+	// Instances stay under their own parent, so only the node itself has to
+	// be static; moving ancestors carry the whole MultiMeshInstance along.
+	std::vector<InstanceGroup> groups;
+	std::map<std::pair<Node *, Mesh *>, size_t> group_indices;
+	for (GLTFNodeIndex node_i = 0; node_i < state->nodes.size(); node_i++) {
+		Ref<GLTFNode> node = state->nodes[node_i];
+		if (node->mesh < 0 || node->skin >= 0 || node->skeleton >= 0 || animated[node_i] || !state->scene_nodes.has(node_i)) {
+			continue;
+		}
+		MeshInstance *mi = Object::cast_to<MeshInstance>(state->scene_nodes[node_i]);
+		if (!mi || mi->get_child_count() || !mi->is_visible() || mi->has_meta("gltf_lods") || mi->get_material_override().is_valid()) {
+			continue;
+		}
+		Ref<Mesh> mesh = mi->get_mesh();
+		if (mesh.is_null() || mesh->get_blend_shape_count() || Object::cast_to<BoneAttachment>(mi->get_parent())) {
+			continue;
+		}
+		bool has_surface_override = false;
+		for (int surface_i = 0; surface_i < mesh->get_surface_count(); surface_i++) {
+			has_surface_override = has_surface_override || mi->get_surface_material(surface_i).is_valid();
+		}
+		if (has_surface_override) {
+			continue;
+		}
+
+		const std::pair<Node *, Mesh *> key(mi->get_parent(), mesh.ptr());
+		std::map<std::pair<Node *, Mesh *>, size_t>::iterator group_i = group_indices.find(key);
+		if (group_i == group_indices.end()) {
+			group_i = group_indices.insert(std::make_pair(key, groups.size())).first;
+			groups.push_back(InstanceGroup());
+			groups.back().parent = mi->get_parent();
+			groups.back().mesh = mesh;
+		}
+		groups[group_i->second].instances.push_back(mi);
+		groups[group_i->second].node_indices.push_back(node_i);
+	}
+
+	int instanced_groups = 0;
+	int instanced_nodes = 0;
+	for (size_t group_i = 0; group_i < groups.size(); group_i++) {
+		InstanceGroup &group = groups[group_i];
+		if ((int)group.instances.size() < MAX(state->multimesh_min_instances, 2)) {
+			continue;
+		}
+
+		Ref<MultiMesh> multi_mesh;
+		multi_mesh.instance();
+		multi_mesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+		multi_mesh->set_mesh(group.mesh);
+		multi_mesh->set_instance_count(group.instances.size());
+		for (size_t instance_i = 0; instance_i < group.instances.size(); instance_i++) {
+			multi_mesh->set_instance_transform(instance_i, group.instances[instance_i]->get_transform());
+		}
+
+		MultiMeshInstance *mmi = MultiMeshInstance::_new();
+		mmi->set_multimesh(multi_mesh);
+		mmi->set_name(_gen_unique_name(state, group.mesh->get_name() + "_Instances"));
+		group.parent->add_child(mmi);
+		mmi->set_owner(scene_root);
+
+		for (size_t instance_i = 0; instance_i < group.instances.size(); instance_i++) {
+			MeshInstance *mi = group.instances[instance_i];
+			state->scene_nodes.erase(group.node_indices[instance_i]);
+			group.parent->remove_child(mi);
+			// Out of the tree a queued free may never run, delete it right away.
+			mi->free();
+		}
+		instanced_groups++;
+		instanced_nodes += group.instances.size();
+	}
+
+	Dictionary instancing_stats;
+	instancing_stats["multimeshes"] = instanced_groups;
+	instancing_stats["mesh_instances_replaced"] = instanced_nodes;
+	state->import_stats["instancing"] = instancing_stats;
+	print_verbose(str_format("glTF: Replaced {0} mesh instances with {1} MultiMeshInstances", instanced_nodes, instanced_groups));
+}
+
+std::vector<bool> GLTFDocument::_get_animated_nodes(Ref<GLTFState> state) {
+	std::vector<bool> animated(state->nodes.size(), false);
+	for (int anim_i = 0; anim_i < state->animations.size(); anim_i++) {
+		Ref<GLTFAnimation> anim = state->animations[anim_i];
+		for (Map<int, GLTFAnimation::Track>::Element *track_i = anim->get_tracks().front(); track_i; track_i = track_i->next()) {
+			if (track_i->key() >= 0 && track_i->key() < state->nodes.size()) {
+				animated[track_i->key()] = true;
+			}
+		}
+	}
+	return animated;
+}
+
+std::vector<bool> GLTFDocument::_get_moving_nodes(Ref<GLTFState> state) {
+	const std::vector<bool> animated = _get_animated_nodes(state);
+
+	// A node also moves when any of its ancestors is animated.
+	std::vector<bool> moving(state->nodes.size(), false);
+	for (GLTFNodeIndex node_i = 0; node_i < state->nodes.size(); node_i++) {
+		for (GLTFNodeIndex current_i = node_i; current_i >= 0; current_i = state->nodes[current_i]->parent) {
+			if (animated[current_i]) {
+				moving[node_i] = true;
+				break;
+			}
+		}
+	}
+	return moving;
+}
+
+bool GLTFDocument::_get_static_transform(Node *p_node, Node *p_scene_root, Transform &r_xform) {
+	Spatial *spatial = Object::cast_to<Spatial>(p_node);
+	ERR_FAIL_COND_V(!spatial, false);
+	r_xform = spatial->get_transform();
+	for (Node *parent = p_node->get_parent(); parent != p_scene_root; parent = parent->get_parent()) {
+		// Bone driven parents only get their transform at runtime.
+		Spatial *parent_spatial = Object::cast_to<Spatial>(parent);
+		if (!parent_spatial || Object::cast_to<Skeleton>(parent) || Object::cast_to<BoneAttachment>(parent)) {
+			return false;
+		}
+		r_xform = parent_spatial->get_transform() * r_xform;
+	}
+	return true;
+}
+
+Array GLTFDocument::_transform_surface_arrays(const Array &p_arrays, const Transform &p_xform) {
+	Array arrays = p_arrays.duplicate();
+	const Basis normal_basis = p_xform.basis.inverse().transposed();
+	const bool flip = p_xform.basis.determinant() < 0.0f;
+
+	PoolVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+	{
+		const int vertex_count = vertices.size();
+		PoolVector3Array::Write w = vertices.write();
+		for (int i = 0; i < vertex_count; i++) {
+			w[i] = p_xform.xform(w[i]);
 		}
 	}
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+
+	if (arrays[Mesh::ARRAY_NORMAL].get_type() == Variant::POOL_VECTOR3_ARRAY) {
+		PoolVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+		const int normal_count = normals.size();
+		PoolVector3Array::Write w = normals.write();
+		for (int i = 0; i < normal_count; i++) {
+			w[i] = normal_basis.xform(w[i]).normalized();
+		}
+		arrays[Mesh::ARRAY_NORMAL] = normals;
+	}
+
+	if (arrays[Mesh::ARRAY_TANGENT].get_type() == Variant::POOL_REAL_ARRAY) {
+		PoolRealArray tangents = arrays[Mesh::ARRAY_TANGENT];
+		const int tangent_count = tangents.size() / 4;
+		PoolRealArray::Write w = tangents.write();
+		for (int i = 0; i < tangent_count; i++) {
+			const Vector3 tangent = p_xform.basis.xform(Vector3(w[i * 4 + 0], w[i * 4 + 1], w[i * 4 + 2])).normalized();
+			w[i * 4 + 0] = tangent.x;
+			w[i * 4 + 1] = tangent.y;
+			w[i * 4 + 2] = tangent.z;
+			if (flip) {
+				w[i * 4 + 3] = -w[i * 4 + 3];
+			}
+		}
+		arrays[Mesh::ARRAY_TANGENT] = tangents;
+	}
+
+	if (flip && arrays[Mesh::ARRAY_INDEX].get_type() == Variant::POOL_INT_ARRAY) {
+		// Mirroring turns the triangles inside out, restore the winding.
+		PoolIntArray indices = arrays[Mesh::ARRAY_INDEX];
+		const int index_count = indices.size();
+		PoolIntArray::Write w = indices.write();
+		for (int i = 0; i + 2 < index_count; i += 3) {
+			SWAP(w[i + 1], w[i + 2]);
+		}
+		arrays[Mesh::ARRAY_INDEX] = indices;
+	}
+	return arrays;
+}
+
+void GLTFDocument::_batch_static_meshes(Ref<GLTFState> state, Node *scene_root) {
+	struct CellBatch {
+		std::vector<SurfaceData> surfaces;
+		std::vector<MeshInstance *> instances;
+		std::vector<GLTFNodeIndex> node_indices;
+	};
+
+	const std::vector<bool> moving = _get_moving_nodes(state);
+	const real_t cell_size = state->static_batch_cell_size;
+	std::map<std::tuple<int, int, int>, CellBatch> cells;
+	int candidates = 0;
+
+	for (GLTFNodeIndex node_i = 0; node_i < state->nodes.size(); node_i++) {
+		Ref<GLTFNode> node = state->nodes[node_i];
+		if (node->mesh < 0 || node->skin >= 0 || node->skeleton >= 0 || node->camera >= 0 || moving[node_i]) {
+			continue;
+		}
+		if (!state->scene_nodes.has(node_i)) {
+			continue;
+		}
+		MeshInstance *mi = Object::cast_to<MeshInstance>(state->scene_nodes[node_i]);
+		if (!mi || mi->get_child_count() || !mi->is_visible() || mi->has_meta("gltf_lods")) {
+			continue;
+		}
+		Ref<ArrayMesh> mesh = mi->get_mesh();
+		if (mesh.is_null() || mesh->get_blend_shape_count()) {
+			continue;
+		}
+		Transform xform;
+		if (!_get_static_transform(mi, scene_root, xform)) {
+			continue;
+		}
+		bool indexed_triangles = true;
+		for (int surface_i = 0; surface_i < mesh->get_surface_count(); surface_i++) {
+			indexed_triangles = indexed_triangles && mesh->surface_get_primitive_type(surface_i) == Mesh::PRIMITIVE_TRIANGLES &&
+								(mesh->surface_get_format(surface_i) & Mesh::ARRAY_FORMAT_INDEX);
+		}
+		if (!indexed_triangles) {
+			continue;
+		}
+
+		std::tuple<int, int, int> cell(0, 0, 0);
+		if (cell_size > 0.0f) {
+			const AABB aabb = xform.xform(mesh->get_aabb());
+			const Vector3 center = (aabb.position + aabb.size * 0.5f) / cell_size;
+			cell = std::make_tuple((int)std::floor(center.x), (int)std::floor(center.y), (int)std::floor(center.z));
+		}
+		CellBatch &batch = cells[cell];
+		for (int surface_i = 0; surface_i < mesh->get_surface_count(); surface_i++) {
+			SurfaceData surface;
+			surface.primitive = Mesh::PRIMITIVE_TRIANGLES;
+			surface.arrays = _transform_surface_arrays(mesh->surface_get_arrays(surface_i), xform);
+			surface.material = mi->get_surface_material(surface_i);
+			if (surface.material.is_null()) {
+				surface.material = mesh->surface_get_material(surface_i);
+			}
+			batch.surfaces.push_back(surface);
+		}
+		batch.instances.push_back(mi);
+		batch.node_indices.push_back(node_i);
+		candidates++;
+	}
+
+	int batches = 0;
+	int batched_instances = 0;
+	for (std::map<std::tuple<int, int, int>, CellBatch>::iterator cell_i = cells.begin(); cell_i != cells.end(); ++cell_i) {
+		CellBatch &batch = cell_i->second;
+		if (batch.instances.size() < 2) {
+			continue;
+		}
+		_merge_surfaces(batch.surfaces);
+
+		Ref<ArrayMesh> batch_mesh;
+		batch_mesh.instance();
+		const String name = _gen_unique_name(state, "StaticBatch");
+		batch_mesh->set_name(name);
+		for (size_t surface_i = 0; surface_i < batch.surfaces.size(); surface_i++) {
+			batch_mesh->add_surface_from_arrays(batch.surfaces[surface_i].primitive, batch.surfaces[surface_i].arrays);
+			batch_mesh->surface_set_material(surface_i, batch.surfaces[surface_i].material);
+		}
+
+		MeshInstance *batch_instance = MeshInstance::_new();
+		batch_instance->set_mesh(batch_mesh);
+		batch_instance->set_name(name);
+		scene_root->add_child(batch_instance);
+		batch_instance->set_owner(scene_root);
+
+		for (size_t instance_i = 0; instance_i < batch.instances.size(); instance_i++) {
+			MeshInstance *mi = batch.instances[instance_i];
+			state->scene_nodes.erase(batch.node_indices[instance_i]);
+			mi->get_parent()->remove_child(mi);
+			// Out of the tree a queued free may never run, delete it right away.
+			mi->free();
+		}
+		batches++;
+		batched_instances += batch.instances.size();
+	}
+
+	Dictionary batch_stats;
+	batch_stats["candidates"] = candidates;
+	batch_stats["mesh_instances_batched"] = batched_instances;
+	batch_stats["batches"] = batches;
+	state->import_stats["static_batching"] = batch_stats;
+	print_verbose(str_format("glTF: Batched {0} static mesh instances into {1} meshes", batched_instances, batches));
 }
 
 void GLTFDocument::_convert_animation_track(Ref<GLTFState> state, GLTFAnimation::Track &p_track, Ref<Animation> p_animation, Transform p_bone_rest, int32_t p_track_i, GLTFNodeIndex p_node_i) {
@@ -6768,6 +10397,30 @@ Error GLTFDocument::parse(Ref<GLTFState> state, String p_path, const PoolByteArr
 	state->major_version = version.split(".")[0].to_int();
 	state->minor_version = version.split(".")[1].to_int();
 
+	// KHR_texture_basisu is not listed: only its raw-format KTX2 images are
+	// loaded, Basis Universal data falls back to the texture's source image.
+	static const char *SUPPORTED_EXTENSIONS[] = {
+		"EXT_mesh_gpu_instancing",
+		"EXT_texture_webp",
+		"KHR_lights_punctual",
+		"KHR_materials_pbrSpecularGlossiness",
+		"KHR_texture_transform",
+		"MSFT_lod",
+	};
+	if (state->json.has("extensionsRequired")) {
+		const Array &required = state->json["extensionsRequired"];
+		for (int i = 0; i < required.size(); i++) {
+			const String extension = required[i];
+			bool supported = false;
+			for (size_t j = 0; j < sizeof(SUPPORTED_EXTENSIONS) / sizeof(SUPPORTED_EXTENSIONS[0]) && !supported; j++) {
+				supported = extension == SUPPORTED_EXTENSIONS[j];
+			}
+			if (!supported) {
+				WARN_PRINT("glTF: Required extension '" + extension + "' is not supported, the imported scene may be incomplete.");
+			}
+		}
+	}
+
 	/* STEP 0 PARSE SCENE */
 	err = _parse_scenes(state);
 	if (err != OK) {
@@ -6816,6 +10469,14 @@ Error GLTFDocument::parse(Ref<GLTFState> state, String p_path, const PoolByteArr
 		return Error::FAILED;
 	}
 
+	/* STEP 8 PACK TEXTURE ATLASES */
+	if (state->atlas_textures) {
+		err = _build_texture_atlases(state);
+		if (err != OK) {
+			return Error::FAILED;
+		}
+	}
+
 	/* STEP 9 PARSE SKINS */
 	err = _parse_skins(state);
 	if (err != OK) {
@@ -6846,6 +10507,22 @@ Error GLTFDocument::parse(Ref<GLTFState> state, String p_path, const PoolByteArr
 		return Error::FAILED;
 	}
 
+	/* STEP 13.5 GENERATE MESH LODS */
+	if (state->generate_lods) {
+		err = _generate_mesh_lods(state);
+		if (err != OK) {
+			return Error::FAILED;
+		}
+	}
+
+	/* STEP 13.6 SPLIT OVERSIZED MESHES */
+	if (state->chunk_large_meshes) {
+		err = _split_mesh_chunks(state);
+		if (err != OK) {
+			return Error::FAILED;
+		}
+	}
+
 	/* STEP 14 PARSE LIGHTS */
 	err = _parse_lights(state);
 	if (err != OK) {
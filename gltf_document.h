@@ -43,13 +43,18 @@
 #include <Animation.hpp>
 #include <AnimationPlayer.hpp>
 #include <Material.hpp>
+#include <Mesh.hpp>
 #include <ResourceLoader.hpp>
 #include <NativeScript.hpp>
 #include <SpatialMaterial.hpp>
+#include <Image.hpp>
 #include <Texture.hpp>
 #include <Camera.hpp>
 #include "vector.h"
 #include "map.h"
+
+#include <map>
+#include <vector>
 using namespace godot;
 
 namespace godot{
@@ -125,6 +130,14 @@ public:
 		COMPONENT_TYPE_FLOAT = 5126,
 	};
 
+	// A surface waiting to be added to an ArrayMesh.
+	struct SurfaceData {
+		Mesh::PrimitiveType primitive = Mesh::PRIMITIVE_TRIANGLES;
+		Array arrays;
+		Array morphs;
+		Ref<Material> material;
+	};
+
 private:
 	template <class T>
 	static Array to_array(const Vector<T> &p_inp) {
@@ -195,6 +208,8 @@ private:
 	GLTFTextureIndex _set_texture(Ref<GLTFState> state, Ref<Texture> p_texture);
 	Ref<Texture> _get_texture(Ref<GLTFState> state,
 			const GLTFTextureIndex p_texture);
+	Ref<Texture> _get_materialized_texture(Ref<GLTFState> state,
+			const GLTFTextureIndex p_texture);
 	Error _parse_json(PoolByteArray bytes, Ref<GLTFState> state);
 	Error _parse_glb(const PoolByteArray bytes, Ref<GLTFState> state);
 	void _compute_node_heights(Ref<GLTFState> state);
@@ -255,16 +270,39 @@ private:
 			const bool p_for_vertex,
 			Vector<Transform> &out_buffer);
 
+	bool _get_accessor_bounds(Ref<GLTFState> state, const GLTFAccessorIndex p_accessor, AABB &r_aabb);
+	static bool _vertices_within_bounds(const PoolVector3Array &p_vertices, const AABB &p_aabb);
+	static bool _reduce_bone_influences(const std::vector<PoolIntArray> &p_joint_sets, const std::vector<PoolRealArray> &p_weight_sets, int p_max_influences, PoolIntArray &r_joints, PoolRealArray &r_weights);
 	Error _parse_meshes(Ref<GLTFState> state);
+	static Array _gather_surface_vertices(const Array &p_arrays, const std::vector<int> &p_vertices);
+	static int _weld_surface_vertices(Array &r_array, Array &r_morphs, float p_epsilon);
+	static void _merge_surfaces(std::vector<SurfaceData> &r_surfaces);
+	Error _generate_mesh_lods(Ref<GLTFState> state);
+	Error _split_mesh_chunks(Ref<GLTFState> state);
+	void _assign_mesh_lods(Ref<GLTFState> state, MeshInstance *mi, const GLTFNodeIndex node_index);
 	Error _serialize_textures(Ref<GLTFState> state);
+	static Ref<Image> _bleed_image_alpha(Ref<Image> p_image, int p_threads);
+	static void _generate_image_mipmaps(Ref<Image> p_image, bool p_srgb, int p_threads);
 	Error _serialize_images(Ref<GLTFState> state, const String &p_path);
 	Error _serialize_lights(Ref<GLTFState> state);
 	Error _parse_images(Ref<GLTFState> state, const String &p_base_path);
+	std::vector<int> _get_image_size_limits(Ref<GLTFState> state);
+	std::vector<bool> _get_color_images(Ref<GLTFState> state);
+	std::vector<int> _get_image_texture_flags(Ref<GLTFState> state, int &r_conflicts);
+	void _apply_texture_budget(Ref<GLTFState> state);
+	void _decode_images(Ref<GLTFState> state, const std::vector<int> &p_images);
+	static std::vector<GLTFImageIndex> _get_texture_image_sources(const Dictionary &p_texture);
 	Error _parse_textures(Ref<GLTFState> state);
 	Error _parse_materials(Ref<GLTFState> state);
+	static uint64_t _hash_material(Ref<Material> p_material, const std::map<const Object *, uint64_t> &p_texture_keys);
+	static bool _materials_equal(Ref<Material> p_a, Ref<Material> p_b, const std::map<const Object *, uint64_t> &p_texture_keys);
+	Ref<Material> _canonicalize_material(Ref<GLTFState> state, Ref<Material> p_material);
+	Ref<SpatialMaterial> _get_vertex_color_material(Ref<GLTFState> state, Ref<SpatialMaterial> p_material);
+	Error _build_texture_atlases(Ref<GLTFState> state);
 	void _set_texture_transform_uv1(const Dictionary &d, Ref<SpatialMaterial> material);
+	static bool _get_texture_transform(const Dictionary &p_texture_info, Transform2D &r_transform);
 	void spec_gloss_to_rough_metal(Ref<GLTFSpecGloss> r_spec_gloss,
-			Ref<SpatialMaterial> p_material);
+			Ref<SpatialMaterial> p_material, int p_threads);
 	static void spec_gloss_to_metal_base_color(const Color &p_specular_factor,
 			const Color &p_diffuse,
 			Color &r_base_color,
@@ -301,6 +339,9 @@ private:
 			const GLTFNodeIndex node_index,
 			const GLTFNodeIndex bone_index);
 	Spatial *_generate_mesh_instance(Ref<GLTFState> state, Node *scene_parent, const GLTFNodeIndex node_index);
+	Spatial *_generate_gpu_instanced_mesh(Ref<GLTFState> state, Node *scene_parent, const GLTFNodeIndex node_index);
+	bool _is_mesh_chunked(Ref<GLTFState> state, const GLTFNodeIndex node_index);
+	void _generate_mesh_chunks(Ref<GLTFState> state, Spatial *scene_parent, Spatial *scene_root, const GLTFNodeIndex node_index);
 	Camera *_generate_camera(Ref<GLTFState> state, Node *scene_parent,
 			const GLTFNodeIndex node_index);
 	Spatial *_generate_light(Ref<GLTFState> state, Node *scene_parent, const GLTFNodeIndex node_index);
@@ -421,6 +462,19 @@ public:
 
 public:
 	void _process_mesh_instances(Ref<GLTFState> state, Node *scene_root);
+	// Partition meshes and skins of a (mesh, skin) pair, empty when it doesn't need splitting.
+	typedef std::map<std::pair<const Object *, const Object *>, std::vector<std::pair<Ref<ArrayMesh>, Ref<Skin>>>> SkinPaletteCache;
+	bool _split_skinned_mesh_by_palette(Ref<GLTFState> state, MeshInstance *mi, Skeleton *skeleton, Ref<Skin> skin, SkinPaletteCache &r_cache);
+	std::vector<std::pair<Ref<ArrayMesh>, Ref<Skin>>> _build_skin_palette_partitions(Ref<GLTFState> state, Ref<ArrayMesh> mesh, Ref<Skin> skin);
+	static std::vector<bool> _get_animated_nodes(Ref<GLTFState> state);
+	static std::vector<bool> _get_moving_nodes(Ref<GLTFState> state);
+	static bool _get_static_transform(Node *p_node, Node *p_scene_root, Transform &r_xform);
+	static Array _transform_surface_arrays(const Array &p_arrays, const Transform &p_xform);
+	void _batch_static_meshes(Ref<GLTFState> state, Node *scene_root);
+	void _instance_repeated_meshes(Ref<GLTFState> state, Node *scene_root);
+	int prefetch_images(Ref<GLTFState> state, int64_t p_budget);
+	void materialize_images(Ref<GLTFState> state, PoolIntArray p_images);
+	void _materialize_scene_images(Ref<GLTFState> state, Node *scene_root);
 	void _generate_scene_node(Ref<GLTFState> state, Node *scene_parent,
 			Spatial *scene_root,
 			const GLTFNodeIndex node_index);
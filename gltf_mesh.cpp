@@ -35,6 +35,9 @@ void GLTFMesh::_register_methods() {
 
 	register_property<GLTFMesh, Ref<ArrayMesh>>("mesh", &GLTFMesh::set_mesh, &GLTFMesh::get_mesh, Ref<ArrayMesh>());
 	register_property<GLTFMesh, PoolRealArray>("blend_weights", &GLTFMesh::set_blend_weights, &GLTFMesh::get_blend_weights, PoolRealArray()); // Vector<float>
+	register_property<GLTFMesh, Array>("lods", &GLTFMesh::set_lods, &GLTFMesh::get_lods, Array()); // Vector<Ref<ArrayMesh>>
+	register_property<GLTFMesh, PoolRealArray>("lod_distances", &GLTFMesh::set_lod_distances, &GLTFMesh::get_lod_distances, PoolRealArray()); // Vector<float>
+	register_property<GLTFMesh, Array>("chunks", &GLTFMesh::set_chunks, &GLTFMesh::get_chunks, Array()); // Vector<Ref<ArrayMesh>>
 }
 
 Ref<ArrayMesh> GLTFMesh::get_mesh() {
@@ -52,3 +55,27 @@ PoolRealArray GLTFMesh::get_blend_weights() {
 void GLTFMesh::set_blend_weights(PoolRealArray p_blend_weights) {
 	blend_weights = p_blend_weights;
 }
+
+Array GLTFMesh::get_lods() {
+	return lods;
+}
+
+void GLTFMesh::set_lods(Array p_lods) {
+	lods = p_lods;
+}
+
+PoolRealArray GLTFMesh::get_lod_distances() {
+	return lod_distances;
+}
+
+void GLTFMesh::set_lod_distances(PoolRealArray p_lod_distances) {
+	lod_distances = p_lod_distances;
+}
+
+Array GLTFMesh::get_chunks() {
+	return chunks;
+}
+
+void GLTFMesh::set_chunks(Array p_chunks) {
+	chunks = p_chunks;
+}
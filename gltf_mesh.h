@@ -42,6 +42,9 @@ class GLTFMesh : public Resource {
 private:
 	Ref<ArrayMesh> mesh;
 	PoolRealArray blend_weights;
+	Array lods;
+	PoolRealArray lod_distances;
+	Array chunks;
 
 public:
 	static void _register_methods();
@@ -52,5 +55,11 @@ public:
 	void set_mesh(Ref<ArrayMesh> p_mesh);
 	PoolRealArray get_blend_weights();
 	void set_blend_weights(PoolRealArray p_blend_weights);
+	Array get_lods();
+	void set_lods(Array p_lods);
+	PoolRealArray get_lod_distances();
+	void set_lod_distances(PoolRealArray p_lod_distances);
+	Array get_chunks();
+	void set_chunks(Array p_chunks);
 };
 #endif // GLTF_MESH_H
@@ -0,0 +1,122 @@
+/*************************************************************************/
+/*  gltf_mipmaps.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gltf_mipmaps.h"
+#include "thread_work_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Linear to sRGB lookup resolution, fine enough to stay within one 8-bit step.
+static const int MIPMAP_SRGB_TABLE_SIZE = 4096;
+// Rows of a level each worker task downsamples.
+static const int MIPMAP_ROWS_PER_TASK = 32;
+
+struct MipmapSRGBTables {
+	float to_linear[256];
+	unsigned char to_srgb[MIPMAP_SRGB_TABLE_SIZE];
+
+	MipmapSRGBTables() {
+		for (int i = 0; i < 256; i++) {
+			const float c = i / 255.0f;
+			to_linear[i] = c < 0.04045f ? c * (1.0f / 12.92f) : powf((c + 0.055f) * (1.0f / 1.055f), 2.4f);
+		}
+		for (int i = 0; i < MIPMAP_SRGB_TABLE_SIZE; i++) {
+			const float c = (float)i / (MIPMAP_SRGB_TABLE_SIZE - 1);
+			const float srgb = c < 0.0031308f ? 12.92f * c : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+			to_srgb[i] = (unsigned char)std::min(std::max((int)(srgb * 255.0f + 0.5f), 0), 255);
+		}
+	}
+};
+
+static const MipmapSRGBTables &_get_srgb_tables() {
+	static const MipmapSRGBTables tables;
+	return tables;
+}
+
+int gltf_mipmap_chain_size(int p_width, int p_height, int p_channels) {
+	int size = 0;
+	int width = p_width;
+	int height = p_height;
+	while (true) {
+		size += width * height * p_channels;
+		if (width == 1 && height == 1) {
+			break;
+		}
+		width = std::max(width >> 1, 1);
+		height = std::max(height >> 1, 1);
+	}
+	return size;
+}
+
+void gltf_generate_mipmaps(unsigned char *p_data, int p_width, int p_height, int p_channels, bool p_srgb, int p_threads) {
+	const MipmapSRGBTables &tables = _get_srgb_tables();
+	// The last channel of luminance-alpha and RGBA images is alpha.
+	const int color_channels = (p_channels == 2 || p_channels == 4) ? p_channels - 1 : p_channels;
+
+	unsigned char *src = p_data;
+	int src_width = p_width;
+	int src_height = p_height;
+	while (src_width > 1 || src_height > 1) {
+		const int dst_width = std::max(src_width >> 1, 1);
+		const int dst_height = std::max(src_height >> 1, 1);
+		unsigned char *dst = src + src_width * src_height * p_channels;
+
+		const int tasks = (dst_height + MIPMAP_ROWS_PER_TASK - 1) / MIPMAP_ROWS_PER_TASK;
+		ThreadWorkPool::do_work(tasks, p_threads, [&](int p_task) {
+			const int row_end = std::min((p_task + 1) * MIPMAP_ROWS_PER_TASK, dst_height);
+			for (int y = p_task * MIPMAP_ROWS_PER_TASK; y < row_end; y++) {
+				// Odd sizes repeat the last row and column.
+				const unsigned char *row0 = src + std::min(y * 2, src_height - 1) * src_width * p_channels;
+				const unsigned char *row1 = src + std::min(y * 2 + 1, src_height - 1) * src_width * p_channels;
+				unsigned char *out = dst + y * dst_width * p_channels;
+				for (int x = 0; x < dst_width; x++) {
+					const int x0 = std::min(x * 2, src_width - 1) * p_channels;
+					const int x1 = std::min(x * 2 + 1, src_width - 1) * p_channels;
+					for (int c = 0; c < p_channels; c++) {
+						if (p_srgb && c < color_channels) {
+							const float linear = (tables.to_linear[row0[x0 + c]] + tables.to_linear[row0[x1 + c]] +
+														 tables.to_linear[row1[x0 + c]] + tables.to_linear[row1[x1 + c]]) *
+									0.25f;
+							out[c] = tables.to_srgb[(int)(linear * (MIPMAP_SRGB_TABLE_SIZE - 1) + 0.5f)];
+						} else {
+							out[c] = (unsigned char)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+						}
+					}
+					out += p_channels;
+				}
+			}
+		});
+
+		src = dst;
+		src_width = dst_width;
+		src_height = dst_height;
+	}
+}
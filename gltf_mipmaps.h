@@ -0,0 +1,48 @@
+/*************************************************************************/
+/*  gltf_mipmaps.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GLTF_MIPMAPS_H
+#define GLTF_MIPMAPS_H
+
+// Size in bytes of an 8-bit image with p_channels channels and all its
+// mipmaps down to 1x1, laid out like Image stores them.
+int gltf_mipmap_chain_size(int p_width, int p_height, int p_channels);
+
+// Builds the mipmaps of an 8-bit image in place. p_data starts with level 0
+// and has room for the whole chain (see gltf_mipmap_chain_size). Every level
+// is a 2x2 box filter of the previous one. With p_srgb the color channels are
+// averaged in linear light, so color textures don't darken in the distance;
+// the alpha channel of 2 and 4 channel images is always averaged as is.
+//
+// The rows of each level are split over up to p_threads workers (0 picks the
+// hardware concurrency, 1 runs on the calling thread).
+void gltf_generate_mipmaps(unsigned char *p_data, int p_width, int p_height, int p_channels, bool p_srgb, int p_threads);
+
+#endif // GLTF_MIPMAPS_H
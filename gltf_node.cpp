@@ -46,6 +46,9 @@ void GLTFNode::_register_methods() {
 	register_property<GLTFNode, Vector3>("scale", &GLTFNode::set_scale, &GLTFNode::get_scale, Vector3(1,1,1)); // Vector3
 	register_property<GLTFNode, PoolIntArray>("children", &GLTFNode::set_children, &GLTFNode::get_children, PoolIntArray()); // Vector<int>
 	register_property<GLTFNode, int>("light", &GLTFNode::set_light, &GLTFNode::get_light, -1); // GLTFLightIndex
+	register_property<GLTFNode, PoolIntArray>("lods", &GLTFNode::set_lods, &GLTFNode::get_lods, PoolIntArray()); // Vector<GLTFNodeIndex>
+	register_property<GLTFNode, PoolRealArray>("lod_screen_coverage", &GLTFNode::set_lod_screen_coverage, &GLTFNode::get_lod_screen_coverage, PoolRealArray()); // Vector<float>
+	register_property<GLTFNode, Dictionary>("instancing_attributes", &GLTFNode::set_instancing_attributes, &GLTFNode::get_instancing_attributes, Dictionary()); // Map<String, GLTFAccessorIndex>
 }
 
 GLTFNodeIndex GLTFNode::get_parent() {
@@ -151,3 +154,27 @@ GLTFLightIndex GLTFNode::get_light() {
 void GLTFNode::set_light(GLTFLightIndex p_light) {
 	light = p_light;
 }
+
+PoolIntArray GLTFNode::get_lods() {
+	return lods;
+}
+
+void GLTFNode::set_lods(PoolIntArray p_lods) {
+	lods = p_lods;
+}
+
+PoolRealArray GLTFNode::get_lod_screen_coverage() {
+	return lod_screen_coverage;
+}
+
+void GLTFNode::set_lod_screen_coverage(PoolRealArray p_lod_screen_coverage) {
+	lod_screen_coverage = p_lod_screen_coverage;
+}
+
+Dictionary GLTFNode::get_instancing_attributes() {
+	return instancing_attributes;
+}
+
+void GLTFNode::set_instancing_attributes(Dictionary p_instancing_attributes) {
+	instancing_attributes = p_instancing_attributes;
+}
@@ -56,6 +56,9 @@ private:
 	Vector3 scale = Vector3(1, 1, 1);
 	PoolIntArray children;
 	GLTFLightIndex light = -1;
+	PoolIntArray lods;
+	PoolRealArray lod_screen_coverage;
+	Dictionary instancing_attributes;
 
 public:
 	static void _register_methods();
@@ -100,5 +103,14 @@ public:
 
 	GLTFLightIndex get_light();
 	void set_light(GLTFLightIndex p_light);
+
+	PoolIntArray get_lods();
+	void set_lods(PoolIntArray p_lods);
+
+	PoolRealArray get_lod_screen_coverage();
+	void set_lod_screen_coverage(PoolRealArray p_lod_screen_coverage);
+
+	Dictionary get_instancing_attributes();
+	void set_instancing_attributes(Dictionary p_instancing_attributes);
 };
 #endif // GLTF_NODE_H
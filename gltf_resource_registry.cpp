@@ -0,0 +1,134 @@
+/*************************************************************************/
+/*  gltf_resource_registry.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gltf_resource_registry.h"
+
+std::mutex GLTFResourceRegistry::mutex;
+std::unordered_map<uint64_t, int64_t> GLTFResourceRegistry::entries;
+std::map<String, GLTFResourceRegistry::Stats> GLTFResourceRegistry::stats;
+size_t GLTFResourceRegistry::prune_size = 64;
+std::unordered_map<uint64_t, PoolByteArray> GLTFResourceRegistry::data_entries;
+int64_t GLTFResourceRegistry::data_bytes = 0;
+
+static Resource *_resource_from_id(int64_t p_id) {
+	godot_object *object = godot::core_1_1_api->godot_instance_from_id((godot_int)p_id);
+	if (!object) {
+		return nullptr;
+	}
+	return Object::cast_to<Resource>(godot::detail::get_wrapper<Object>(object));
+}
+
+void GLTFResourceRegistry::_prune() {
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (_resource_from_id(it->second) == nullptr) {
+			it = entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+	prune_size = entries.size() * 2 + 64;
+}
+
+Ref<Resource> GLTFResourceRegistry::find(const String &p_category, uint64_t p_key) {
+	std::lock_guard<std::mutex> lock(mutex);
+	Stats &category_stats = stats[p_category];
+	auto it = entries.find(p_key);
+	if (it != entries.end()) {
+		Resource *resource = _resource_from_id(it->second);
+		if (resource) {
+			category_stats.hits++;
+			return Ref<Resource>(resource);
+		}
+		entries.erase(it);
+	}
+	category_stats.misses++;
+	return Ref<Resource>();
+}
+
+void GLTFResourceRegistry::add(uint64_t p_key, Ref<Resource> p_resource) {
+	ERR_FAIL_COND(p_resource.is_null());
+	std::lock_guard<std::mutex> lock(mutex);
+	entries[p_key] = p_resource->get_instance_id();
+	if (entries.size() > prune_size) {
+		_prune();
+	}
+}
+
+PoolByteArray GLTFResourceRegistry::find_data(const String &p_category, uint64_t p_key) {
+	std::lock_guard<std::mutex> lock(mutex);
+	Stats &category_stats = stats[p_category];
+	auto it = data_entries.find(p_key);
+	if (it == data_entries.end()) {
+		category_stats.misses++;
+		return PoolByteArray();
+	}
+	category_stats.hits++;
+	return it->second;
+}
+
+void GLTFResourceRegistry::add_data(uint64_t p_key, const PoolByteArray &p_data) {
+	if (p_data.size() == 0 || p_data.size() > DATA_CACHE_MAX_BYTES) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	if (data_entries.count(p_key)) {
+		return;
+	}
+	if (data_bytes + p_data.size() > DATA_CACHE_MAX_BYTES) {
+		// No recency tracking, starting over keeps the bound simple.
+		data_entries.clear();
+		data_bytes = 0;
+	}
+	data_entries[p_key] = p_data;
+	data_bytes += p_data.size();
+}
+
+Dictionary GLTFResourceRegistry::get_stats() {
+	std::lock_guard<std::mutex> lock(mutex);
+	Dictionary result;
+	for (auto it = stats.begin(); it != stats.end(); ++it) {
+		Dictionary category;
+		category["hits"] = it->second.hits;
+		category["misses"] = it->second.misses;
+		result[it->first] = category;
+	}
+	result["entries"] = (int64_t)entries.size();
+	result["data_bytes"] = data_bytes;
+	return result;
+}
+
+void GLTFResourceRegistry::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+	data_entries.clear();
+	data_bytes = 0;
+	stats.clear();
+	prune_size = 64;
+}
@@ -0,0 +1,82 @@
+/*************************************************************************/
+/*  gltf_resource_registry.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GLTF_RESOURCE_REGISTRY_H
+#define GLTF_RESOURCE_REGISTRY_H
+
+#include <Godot.hpp>
+#include <Resource.hpp>
+
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <unordered_map>
+
+using namespace godot;
+
+// Process-wide registry sharing imported resources (textures, materials)
+// between glTF imports, keyed by a hash of the content they were made from.
+// Only instance IDs are kept, so an entry doesn't keep its resource alive
+// and is dropped once the resource has been freed.
+//
+// It also caches encoded data (e.g. exported PNGs) by the hash of what was
+// encoded, bounded by DATA_CACHE_MAX_BYTES.
+class GLTFResourceRegistry {
+	struct Stats {
+		int hits = 0;
+		int misses = 0;
+	};
+
+	static std::mutex mutex;
+	static std::unordered_map<uint64_t, int64_t> entries;
+	static std::map<String, Stats> stats;
+	static size_t prune_size;
+	static std::unordered_map<uint64_t, PoolByteArray> data_entries;
+	static int64_t data_bytes;
+
+	static void _prune();
+
+public:
+	// Returns the live resource registered under p_key, or a null reference.
+	// p_category only groups the hit/miss statistics.
+	static Ref<Resource> find(const String &p_category, uint64_t p_key);
+	static void add(uint64_t p_key, Ref<Resource> p_resource);
+
+	static const int64_t DATA_CACHE_MAX_BYTES = 256 * 1024 * 1024;
+	// Returns the cached data for p_key, or an empty array.
+	static PoolByteArray find_data(const String &p_category, uint64_t p_key);
+	static void add_data(uint64_t p_key, const PoolByteArray &p_data);
+
+	// Hits and misses per category since the last clear().
+	static Dictionary get_stats();
+	static void clear();
+};
+
+#endif // GLTF_RESOURCE_REGISTRY_H
@@ -42,6 +42,45 @@ void GLTFState::_register_methods() {
 	register_property<GLTFState, int>("minor_version", &GLTFState::set_minor_version, &GLTFState::get_minor_version, 0); // int
 	register_property<GLTFState, PoolByteArray>("glb_data", &GLTFState::set_glb_data, &GLTFState::get_glb_data, PoolByteArray()); // Vector<uint8_t>
 	register_property<GLTFState, bool>("use_named_skin_binds", &GLTFState::set_use_named_skin_binds, &GLTFState::get_use_named_skin_binds, false); // bool
+	register_property<GLTFState, bool>("generate_lods", &GLTFState::set_generate_lods, &GLTFState::get_generate_lods, false); // bool
+	register_property<GLTFState, PoolRealArray>("lod_ratios", &GLTFState::set_lod_ratios, &GLTFState::get_lod_ratios, PoolRealArray()); // Vector<float>
+	register_property<GLTFState, float>("lod_target_error", &GLTFState::set_lod_target_error, &GLTFState::get_lod_target_error, 0.02f); // float
+	register_property<GLTFState, float>("lod_pixel_error", &GLTFState::set_lod_pixel_error, &GLTFState::get_lod_pixel_error, 1.0f); // float
+	register_property<GLTFState, int>("worker_thread_count", &GLTFState::set_worker_thread_count, &GLTFState::get_worker_thread_count, 0); // int
+	register_property<GLTFState, bool>("weld_vertices", &GLTFState::set_weld_vertices, &GLTFState::get_weld_vertices, false); // bool
+	register_property<GLTFState, float>("weld_epsilon", &GLTFState::set_weld_epsilon, &GLTFState::get_weld_epsilon, 0.0f); // float
+	register_property<GLTFState, bool>("merge_primitives", &GLTFState::set_merge_primitives, &GLTFState::get_merge_primitives, false); // bool
+	register_property<GLTFState, bool>("batch_static_meshes", &GLTFState::set_batch_static_meshes, &GLTFState::get_batch_static_meshes, false); // bool
+	register_property<GLTFState, float>("static_batch_cell_size", &GLTFState::set_static_batch_cell_size, &GLTFState::get_static_batch_cell_size, 16.0f); // float
+	register_property<GLTFState, bool>("instance_repeated_meshes", &GLTFState::set_instance_repeated_meshes, &GLTFState::get_instance_repeated_meshes, false); // bool
+	register_property<GLTFState, int>("multimesh_min_instances", &GLTFState::set_multimesh_min_instances, &GLTFState::get_multimesh_min_instances, 4); // int
+	register_property<GLTFState, bool>("validate_accessor_bounds", &GLTFState::set_validate_accessor_bounds, &GLTFState::get_validate_accessor_bounds, false); // bool
+	register_property<GLTFState, int>("max_bone_influences", &GLTFState::set_max_bone_influences, &GLTFState::get_max_bone_influences, 4); // int
+	register_property<GLTFState, bool>("chunk_large_meshes", &GLTFState::set_chunk_large_meshes, &GLTFState::get_chunk_large_meshes, false); // bool
+	register_property<GLTFState, int>("chunk_max_triangles", &GLTFState::set_chunk_max_triangles, &GLTFState::get_chunk_max_triangles, 65536); // int
+	register_property<GLTFState, float>("chunk_max_size", &GLTFState::set_chunk_max_size, &GLTFState::get_chunk_max_size, 64.0f); // float
+	register_property<GLTFState, int>("skin_palette_size", &GLTFState::set_skin_palette_size, &GLTFState::get_skin_palette_size, 0); // int
+	register_property<GLTFState, bool>("compress_textures", &GLTFState::set_compress_textures, &GLTFState::get_compress_textures, false); // bool
+	register_property<GLTFState, int>("texture_compress_mode", &GLTFState::set_texture_compress_mode, &GLTFState::get_texture_compress_mode, 0); // Image::CompressMode
+	register_property<GLTFState, String>("texture_cache_path", &GLTFState::set_texture_cache_path, &GLTFState::get_texture_cache_path, String()); // String
+	register_property<GLTFState, bool>("lazy_textures", &GLTFState::set_lazy_textures, &GLTFState::get_lazy_textures, false); // bool
+	register_property<GLTFState, int>("texture_prefetch_budget", &GLTFState::set_texture_prefetch_budget, &GLTFState::get_texture_prefetch_budget, 0); // bytes
+	register_property<GLTFState, bool>("share_resources", &GLTFState::set_share_resources, &GLTFState::get_share_resources, false); // bool
+	register_property<GLTFState, int>("texture_max_size", &GLTFState::set_texture_max_size, &GLTFState::get_texture_max_size, 0); // int
+	register_property<GLTFState, int>("texture_max_size_albedo", &GLTFState::set_texture_max_size_albedo, &GLTFState::get_texture_max_size_albedo, 0); // int
+	register_property<GLTFState, int>("texture_max_size_normal", &GLTFState::set_texture_max_size_normal, &GLTFState::get_texture_max_size_normal, 0); // int
+	register_property<GLTFState, int>("texture_max_size_orm", &GLTFState::set_texture_max_size_orm, &GLTFState::get_texture_max_size_orm, 0); // int
+	register_property<GLTFState, float>("texture_budget_mb", &GLTFState::set_texture_budget_mb, &GLTFState::get_texture_budget_mb, 0.0f); // float
+	register_property<GLTFState, bool>("bleed_texture_alpha", &GLTFState::set_bleed_texture_alpha, &GLTFState::get_bleed_texture_alpha, false); // bool
+	register_property<GLTFState, bool>("keep_source_images", &GLTFState::set_keep_source_images, &GLTFState::get_keep_source_images, false); // bool
+	register_property<GLTFState, bool>("atlas_textures", &GLTFState::set_atlas_textures, &GLTFState::get_atlas_textures, false); // bool
+	register_property<GLTFState, int>("atlas_max_texture_size", &GLTFState::set_atlas_max_texture_size, &GLTFState::get_atlas_max_texture_size, 256); // int
+	register_property<GLTFState, int>("atlas_page_size", &GLTFState::set_atlas_page_size, &GLTFState::get_atlas_page_size, 2048); // int
+	register_property<GLTFState, bool>("deduplicate_materials", &GLTFState::set_deduplicate_materials, &GLTFState::get_deduplicate_materials, false); // bool
+	register_property<GLTFState, bool>("threaded_mipmaps", &GLTFState::set_threaded_mipmaps, &GLTFState::get_threaded_mipmaps, false); // bool
+	register_property<GLTFState, bool>("import_samplers", &GLTFState::set_import_samplers, &GLTFState::get_import_samplers, false); // bool
+	register_property<GLTFState, bool>("bake_texture_transforms", &GLTFState::set_bake_texture_transforms, &GLTFState::get_bake_texture_transforms, false); // bool
+	register_property<GLTFState, Dictionary>("import_stats", &GLTFState::set_import_stats, &GLTFState::get_import_stats, Dictionary()); // Dictionary
 	register_property<GLTFState, Array>("nodes", &GLTFState::set_nodes, &GLTFState::get_nodes, Array()); // Vector<Ref<GLTFNode>>
 	register_property<GLTFState, Array>("buffers", &GLTFState::set_buffers, &GLTFState::get_buffers, Array()); // Vector<Vector<uint8_t>
 	register_property<GLTFState, Array>("buffer_views", &GLTFState::set_buffer_views, &GLTFState::get_buffer_views, Array()); // Vector<Ref<GLTFBufferView>>
@@ -62,6 +101,13 @@ void GLTFState::_register_methods() {
 	register_property<GLTFState, Array>("animations", &GLTFState::set_animations, &GLTFState::get_animations, Array()); // Vector<Ref<GLTFAnimation>>
 }
 
+void GLTFState::_init() {
+	// Each entry is the fraction of the source triangles kept by one LOD level.
+	lod_ratios.push_back(0.5f);
+	lod_ratios.push_back(0.25f);
+	lod_ratios.push_back(0.125f);
+}
+
 Dictionary GLTFState::get_json() {
 	return json;
 }
@@ -102,6 +148,318 @@ void GLTFState::set_use_named_skin_binds(bool p_use_named_skin_binds) {
 	use_named_skin_binds = p_use_named_skin_binds;
 }
 
+bool GLTFState::get_generate_lods() {
+	return generate_lods;
+}
+
+void GLTFState::set_generate_lods(bool p_generate_lods) {
+	generate_lods = p_generate_lods;
+}
+
+PoolRealArray GLTFState::get_lod_ratios() {
+	return lod_ratios;
+}
+
+void GLTFState::set_lod_ratios(PoolRealArray p_lod_ratios) {
+	lod_ratios = p_lod_ratios;
+}
+
+float GLTFState::get_lod_target_error() {
+	return lod_target_error;
+}
+
+void GLTFState::set_lod_target_error(float p_lod_target_error) {
+	lod_target_error = p_lod_target_error;
+}
+
+float GLTFState::get_lod_pixel_error() {
+	return lod_pixel_error;
+}
+
+void GLTFState::set_lod_pixel_error(float p_lod_pixel_error) {
+	lod_pixel_error = p_lod_pixel_error;
+}
+
+int GLTFState::get_worker_thread_count() {
+	return worker_thread_count;
+}
+
+void GLTFState::set_worker_thread_count(int p_worker_thread_count) {
+	worker_thread_count = p_worker_thread_count;
+}
+
+bool GLTFState::get_weld_vertices() {
+	return weld_vertices;
+}
+
+void GLTFState::set_weld_vertices(bool p_weld_vertices) {
+	weld_vertices = p_weld_vertices;
+}
+
+float GLTFState::get_weld_epsilon() {
+	return weld_epsilon;
+}
+
+void GLTFState::set_weld_epsilon(float p_weld_epsilon) {
+	weld_epsilon = p_weld_epsilon;
+}
+
+bool GLTFState::get_merge_primitives() {
+	return merge_primitives;
+}
+
+void GLTFState::set_merge_primitives(bool p_merge_primitives) {
+	merge_primitives = p_merge_primitives;
+}
+
+bool GLTFState::get_batch_static_meshes() {
+	return batch_static_meshes;
+}
+
+void GLTFState::set_batch_static_meshes(bool p_batch_static_meshes) {
+	batch_static_meshes = p_batch_static_meshes;
+}
+
+float GLTFState::get_static_batch_cell_size() {
+	return static_batch_cell_size;
+}
+
+void GLTFState::set_static_batch_cell_size(float p_static_batch_cell_size) {
+	static_batch_cell_size = p_static_batch_cell_size;
+}
+
+bool GLTFState::get_instance_repeated_meshes() {
+	return instance_repeated_meshes;
+}
+
+void GLTFState::set_instance_repeated_meshes(bool p_instance_repeated_meshes) {
+	instance_repeated_meshes = p_instance_repeated_meshes;
+}
+
+int GLTFState::get_multimesh_min_instances() {
+	return multimesh_min_instances;
+}
+
+void GLTFState::set_multimesh_min_instances(int p_multimesh_min_instances) {
+	multimesh_min_instances = p_multimesh_min_instances;
+}
+
+bool GLTFState::get_validate_accessor_bounds() {
+	return validate_accessor_bounds;
+}
+
+void GLTFState::set_validate_accessor_bounds(bool p_validate_accessor_bounds) {
+	validate_accessor_bounds = p_validate_accessor_bounds;
+}
+
+int GLTFState::get_max_bone_influences() {
+	return max_bone_influences;
+}
+
+void GLTFState::set_max_bone_influences(int p_max_bone_influences) {
+	max_bone_influences = p_max_bone_influences;
+}
+
+bool GLTFState::get_chunk_large_meshes() {
+	return chunk_large_meshes;
+}
+
+void GLTFState::set_chunk_large_meshes(bool p_chunk_large_meshes) {
+	chunk_large_meshes = p_chunk_large_meshes;
+}
+
+int GLTFState::get_chunk_max_triangles() {
+	return chunk_max_triangles;
+}
+
+void GLTFState::set_chunk_max_triangles(int p_chunk_max_triangles) {
+	chunk_max_triangles = p_chunk_max_triangles;
+}
+
+float GLTFState::get_chunk_max_size() {
+	return chunk_max_size;
+}
+
+void GLTFState::set_chunk_max_size(float p_chunk_max_size) {
+	chunk_max_size = p_chunk_max_size;
+}
+
+int GLTFState::get_skin_palette_size() {
+	return skin_palette_size;
+}
+
+void GLTFState::set_skin_palette_size(int p_skin_palette_size) {
+	skin_palette_size = p_skin_palette_size;
+}
+
+bool GLTFState::get_compress_textures() {
+	return compress_textures;
+}
+
+void GLTFState::set_compress_textures(bool p_compress_textures) {
+	compress_textures = p_compress_textures;
+}
+
+int GLTFState::get_texture_compress_mode() {
+	return texture_compress_mode;
+}
+
+void GLTFState::set_texture_compress_mode(int p_texture_compress_mode) {
+	texture_compress_mode = p_texture_compress_mode;
+}
+
+String GLTFState::get_texture_cache_path() {
+	return texture_cache_path;
+}
+
+void GLTFState::set_texture_cache_path(String p_texture_cache_path) {
+	texture_cache_path = p_texture_cache_path;
+}
+
+bool GLTFState::get_lazy_textures() {
+	return lazy_textures;
+}
+
+void GLTFState::set_lazy_textures(bool p_lazy_textures) {
+	lazy_textures = p_lazy_textures;
+}
+
+int GLTFState::get_texture_prefetch_budget() {
+	return texture_prefetch_budget;
+}
+
+void GLTFState::set_texture_prefetch_budget(int p_texture_prefetch_budget) {
+	texture_prefetch_budget = p_texture_prefetch_budget;
+}
+
+bool GLTFState::get_share_resources() {
+	return share_resources;
+}
+
+void GLTFState::set_share_resources(bool p_share_resources) {
+	share_resources = p_share_resources;
+}
+
+int GLTFState::get_texture_max_size() {
+	return texture_max_size;
+}
+
+void GLTFState::set_texture_max_size(int p_texture_max_size) {
+	texture_max_size = p_texture_max_size;
+}
+
+int GLTFState::get_texture_max_size_albedo() {
+	return texture_max_size_albedo;
+}
+
+void GLTFState::set_texture_max_size_albedo(int p_texture_max_size_albedo) {
+	texture_max_size_albedo = p_texture_max_size_albedo;
+}
+
+int GLTFState::get_texture_max_size_normal() {
+	return texture_max_size_normal;
+}
+
+void GLTFState::set_texture_max_size_normal(int p_texture_max_size_normal) {
+	texture_max_size_normal = p_texture_max_size_normal;
+}
+
+int GLTFState::get_texture_max_size_orm() {
+	return texture_max_size_orm;
+}
+
+void GLTFState::set_texture_max_size_orm(int p_texture_max_size_orm) {
+	texture_max_size_orm = p_texture_max_size_orm;
+}
+
+float GLTFState::get_texture_budget_mb() {
+	return texture_budget_mb;
+}
+
+void GLTFState::set_texture_budget_mb(float p_texture_budget_mb) {
+	texture_budget_mb = p_texture_budget_mb;
+}
+
+bool GLTFState::get_bleed_texture_alpha() {
+	return bleed_texture_alpha;
+}
+
+void GLTFState::set_bleed_texture_alpha(bool p_bleed_texture_alpha) {
+	bleed_texture_alpha = p_bleed_texture_alpha;
+}
+
+bool GLTFState::get_keep_source_images() {
+	return keep_source_images;
+}
+
+void GLTFState::set_keep_source_images(bool p_keep_source_images) {
+	keep_source_images = p_keep_source_images;
+}
+
+bool GLTFState::get_atlas_textures() {
+	return atlas_textures;
+}
+
+void GLTFState::set_atlas_textures(bool p_atlas_textures) {
+	atlas_textures = p_atlas_textures;
+}
+
+int GLTFState::get_atlas_max_texture_size() {
+	return atlas_max_texture_size;
+}
+
+void GLTFState::set_atlas_max_texture_size(int p_atlas_max_texture_size) {
+	atlas_max_texture_size = p_atlas_max_texture_size;
+}
+
+int GLTFState::get_atlas_page_size() {
+	return atlas_page_size;
+}
+
+void GLTFState::set_atlas_page_size(int p_atlas_page_size) {
+	atlas_page_size = p_atlas_page_size;
+}
+
+bool GLTFState::get_deduplicate_materials() {
+	return deduplicate_materials;
+}
+
+void GLTFState::set_deduplicate_materials(bool p_deduplicate_materials) {
+	deduplicate_materials = p_deduplicate_materials;
+}
+
+bool GLTFState::get_threaded_mipmaps() {
+	return threaded_mipmaps;
+}
+
+void GLTFState::set_threaded_mipmaps(bool p_threaded_mipmaps) {
+	threaded_mipmaps = p_threaded_mipmaps;
+}
+
+bool GLTFState::get_import_samplers() {
+	return import_samplers;
+}
+
+void GLTFState::set_import_samplers(bool p_import_samplers) {
+	import_samplers = p_import_samplers;
+}
+
+bool GLTFState::get_bake_texture_transforms() {
+	return bake_texture_transforms;
+}
+
+void GLTFState::set_bake_texture_transforms(bool p_bake_texture_transforms) {
+	bake_texture_transforms = p_bake_texture_transforms;
+}
+
+Dictionary GLTFState::get_import_stats() {
+	return import_stats;
+}
+
+void GLTFState::set_import_stats(Dictionary p_import_stats) {
+	import_stats = p_import_stats;
+}
+
 Array GLTFState::get_nodes() {
 	return GLTFDocument::to_array(nodes);
 }
@@ -48,9 +48,58 @@
 #include "gltf_texture.h"
 #include <AnimationPlayer.hpp>
 #include <Animation.hpp>
+#include <Image.hpp>
 #include <Texture.hpp>
+#include <map>
+#include <vector>
 using namespace godot;
 
+// Encoded bytes of a glTF image, kept until the image has been decoded.
+struct GLTFImageSource {
+	PoolByteArray data;
+	int offset = 0;
+	int size = 0;
+	String mimetype;
+	bool is_ktx2 = false;
+	Error err = ERR_SKIP;
+	// Hash of the encoded bytes and the settings affecting the decoded result.
+	uint64_t key = 0;
+	// Largest dimension of the decoded image, 0 for no limit.
+	int max_size = 0;
+	// Whether the image holds colors, which are mipmapped in linear light.
+	bool srgb = true;
+	// Texture flags from the image's sampler, -1 for the defaults.
+	int texture_flags = -1;
+	// Next source of a texture using this image, loaded in its place when
+	// this one fails. Images that are only ever a fallback aren't decoded
+	// unless needed.
+	int fallback = -1;
+	bool fallback_only = false;
+
+	// Decode results.
+	Ref<Image> image;
+	bool decoded = false;
+	bool cache_hit = false;
+	bool compressed = false;
+	int64_t decoded_size = 0;
+	int original_width = 0;
+	int original_height = 0;
+	uint64_t decode_usec = 0;
+	uint64_t mipmap_usec = 0;
+	uint64_t compress_usec = 0;
+	// Encoded bytes and decoded pixel hash, kept for export with keep_source_images.
+	PoolByteArray encoded;
+	uint64_t pixel_hash = 0;
+};
+
+// Where a material's albedo texture ended up in a texture atlas page.
+struct GLTFAtlasEntry {
+	// Material sharing the atlas page, null when the material isn't atlased.
+	Ref<Material> material;
+	// Region of the page holding the original texture, in UV space.
+	Rect2 uv_rect;
+};
+
 class GLTFState : public Resource {
 	GODOT_CLASS(GLTFState, Resource);
 	friend class GLTFDocument;
@@ -64,6 +113,51 @@ class GLTFState : public Resource {
 
 	bool use_named_skin_binds = false;
 
+	bool generate_lods = false;
+	PoolRealArray lod_ratios;
+	float lod_target_error = 0.02f;
+	float lod_pixel_error = 1.0f;
+	int worker_thread_count = 0;
+	bool weld_vertices = false;
+	float weld_epsilon = 0.0f;
+	bool merge_primitives = false;
+	bool batch_static_meshes = false;
+	float static_batch_cell_size = 16.0f;
+	bool instance_repeated_meshes = false;
+	int multimesh_min_instances = 4;
+	bool validate_accessor_bounds = false;
+	int max_bone_influences = 4;
+	bool chunk_large_meshes = false;
+	int chunk_max_triangles = 65536;
+	float chunk_max_size = 64.0f;
+	// Splits skinned meshes whose surfaces reference more joints than this
+	// (at least 12) into partitions within that limit, 0 keeps them whole. Every
+	// partition becomes an extra MeshInstance under the Skeleton, named
+	// <mesh>_part<n> and bound to its own Skin, in place of the original
+	// node. Meshes with children, blend shapes or LODs are never split.
+	int skin_palette_size = 0;
+	bool compress_textures = false;
+	int texture_compress_mode = 0;
+	String texture_cache_path;
+	bool lazy_textures = false;
+	int texture_prefetch_budget = 0;
+	bool share_resources = false;
+	int texture_max_size = 0;
+	int texture_max_size_albedo = 0;
+	int texture_max_size_normal = 0;
+	int texture_max_size_orm = 0;
+	float texture_budget_mb = 0.0f;
+	bool bleed_texture_alpha = false;
+	bool keep_source_images = false;
+	bool atlas_textures = false;
+	int atlas_max_texture_size = 256;
+	int atlas_page_size = 2048;
+	bool deduplicate_materials = false;
+	bool threaded_mipmaps = false;
+	bool import_samplers = false;
+	bool bake_texture_transforms = false;
+	Dictionary import_stats;
+
 	Vector<Ref<GLTFNode>> nodes;
 	Vector<PoolByteArray> buffers;
 	Vector<Ref<GLTFBufferView>> buffer_views;
@@ -74,11 +168,21 @@ class GLTFState : public Resource {
 	Vector<AnimationPlayer *> animation_players;
 	Map<Ref<Material>, GLTFMaterialIndex> material_cache;
 	Vector<Ref<Material>> materials;
+	// Canonical materials by parameter hash, see deduplicate_materials.
+	std::multimap<uint64_t, Ref<Material>> canonical_materials;
+	std::map<const Object *, uint64_t> material_texture_keys;
+	// Vertex color variant per source material (null for primitives without one).
+	std::map<const Object *, Ref<Material>> vertex_color_materials;
+	int vertex_color_variants = 0;
+	// KHR_texture_transform of materials whose transform is baked into UVs.
+	std::map<GLTFMaterialIndex, Transform2D> material_uv_transforms;
 
 	String scene_name;
 	Vector<int> root_nodes;
 	Vector<Ref<GLTFTexture>> textures;
 	Vector<Ref<Texture>> images;
+	std::vector<GLTFImageSource> image_sources;
+	std::vector<GLTFAtlasEntry> material_atlas;
 
 	Vector<Ref<GLTFSkin>> skins;
 	Vector<Ref<GLTFCamera>> cameras;
@@ -93,7 +197,7 @@ class GLTFState : public Resource {
 
 public:
 	static void _register_methods();
-	void _init() {}
+	void _init();
 
 public:
 	Dictionary get_json();
@@ -111,6 +215,123 @@ public:
 	bool get_use_named_skin_binds();
 	void set_use_named_skin_binds(bool p_use_named_skin_binds);
 
+	bool get_generate_lods();
+	void set_generate_lods(bool p_generate_lods);
+
+	PoolRealArray get_lod_ratios();
+	void set_lod_ratios(PoolRealArray p_lod_ratios);
+
+	float get_lod_target_error();
+	void set_lod_target_error(float p_lod_target_error);
+
+	float get_lod_pixel_error();
+	void set_lod_pixel_error(float p_lod_pixel_error);
+
+	int get_worker_thread_count();
+	void set_worker_thread_count(int p_worker_thread_count);
+
+	bool get_weld_vertices();
+	void set_weld_vertices(bool p_weld_vertices);
+
+	float get_weld_epsilon();
+	void set_weld_epsilon(float p_weld_epsilon);
+
+	bool get_merge_primitives();
+	void set_merge_primitives(bool p_merge_primitives);
+
+	bool get_batch_static_meshes();
+	void set_batch_static_meshes(bool p_batch_static_meshes);
+
+	float get_static_batch_cell_size();
+	void set_static_batch_cell_size(float p_static_batch_cell_size);
+
+	bool get_instance_repeated_meshes();
+	void set_instance_repeated_meshes(bool p_instance_repeated_meshes);
+
+	int get_multimesh_min_instances();
+	void set_multimesh_min_instances(int p_multimesh_min_instances);
+
+	bool get_validate_accessor_bounds();
+	void set_validate_accessor_bounds(bool p_validate_accessor_bounds);
+
+	int get_max_bone_influences();
+	void set_max_bone_influences(int p_max_bone_influences);
+
+	bool get_chunk_large_meshes();
+	void set_chunk_large_meshes(bool p_chunk_large_meshes);
+
+	int get_chunk_max_triangles();
+	void set_chunk_max_triangles(int p_chunk_max_triangles);
+
+	float get_chunk_max_size();
+	void set_chunk_max_size(float p_chunk_max_size);
+
+	int get_skin_palette_size();
+	void set_skin_palette_size(int p_skin_palette_size);
+
+	bool get_compress_textures();
+	void set_compress_textures(bool p_compress_textures);
+
+	int get_texture_compress_mode();
+	void set_texture_compress_mode(int p_texture_compress_mode);
+
+	String get_texture_cache_path();
+	void set_texture_cache_path(String p_texture_cache_path);
+
+	bool get_lazy_textures();
+	void set_lazy_textures(bool p_lazy_textures);
+
+	int get_texture_prefetch_budget();
+	void set_texture_prefetch_budget(int p_texture_prefetch_budget);
+
+	bool get_share_resources();
+	void set_share_resources(bool p_share_resources);
+
+	int get_texture_max_size();
+	void set_texture_max_size(int p_texture_max_size);
+
+	int get_texture_max_size_albedo();
+	void set_texture_max_size_albedo(int p_texture_max_size_albedo);
+
+	int get_texture_max_size_normal();
+	void set_texture_max_size_normal(int p_texture_max_size_normal);
+
+	int get_texture_max_size_orm();
+	void set_texture_max_size_orm(int p_texture_max_size_orm);
+
+	float get_texture_budget_mb();
+	void set_texture_budget_mb(float p_texture_budget_mb);
+
+	bool get_bleed_texture_alpha();
+	void set_bleed_texture_alpha(bool p_bleed_texture_alpha);
+
+	bool get_keep_source_images();
+	void set_keep_source_images(bool p_keep_source_images);
+
+	bool get_atlas_textures();
+	void set_atlas_textures(bool p_atlas_textures);
+
+	int get_atlas_max_texture_size();
+	void set_atlas_max_texture_size(int p_atlas_max_texture_size);
+
+	int get_atlas_page_size();
+	void set_atlas_page_size(int p_atlas_page_size);
+
+	bool get_deduplicate_materials();
+	void set_deduplicate_materials(bool p_deduplicate_materials);
+
+	bool get_threaded_mipmaps();
+	void set_threaded_mipmaps(bool p_threaded_mipmaps);
+
+	bool get_import_samplers();
+	void set_import_samplers(bool p_import_samplers);
+
+	bool get_bake_texture_transforms();
+	void set_bake_texture_transforms(bool p_bake_texture_transforms);
+
+	Dictionary get_import_stats();
+	void set_import_stats(Dictionary p_import_stats);
+
 	Array get_nodes();
 	void set_nodes(Array p_nodes);
 
@@ -28,8 +28,90 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 
+#include "gltf_texture_bleed.h"
+#include "thread_work_pool.h"
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
 
 #define TEXBLEED_IMPLEMENTATION 1
 #include "thirdparty/misc/rjm_texbleed.h"
+
+// Rows of the neighbouring bands each band reads to find its sources.
+static const int TEXBLEED_BAND_MARGIN = 64;
+static const int TEXBLEED_MIN_BAND_HEIGHT = 128;
+
+// Rows [r_begin, r_end) a band reads. A window without any source is widened
+// to the closest source rows above and below, plus the usual margin, so the
+// band can be filled on its own.
+static void _get_band_window(const std::vector<int> &p_seed_rows, int p_band_begin, int p_band_end, int &r_begin, int &r_end) {
+	const int height = p_seed_rows.size() - 1;
+	r_begin = std::max(p_band_begin - TEXBLEED_BAND_MARGIN, 0);
+	r_end = std::min(p_band_end + TEXBLEED_BAND_MARGIN, height);
+	if (p_seed_rows[r_end] > p_seed_rows[r_begin]) {
+		return;
+	}
+	int above = r_begin - 1;
+	while (above >= 0 && p_seed_rows[above + 1] == p_seed_rows[above]) {
+		above--;
+	}
+	int below = r_end;
+	while (below < height && p_seed_rows[below + 1] == p_seed_rows[below]) {
+		below++;
+	}
+	if (above >= 0) {
+		r_begin = std::max(above - TEXBLEED_BAND_MARGIN, 0);
+	}
+	if (below < height) {
+		r_end = std::min(below + 1 + TEXBLEED_BAND_MARGIN, height);
+	}
+}
+
+bool gltf_texture_bleed(unsigned char *p_pixels, int p_width, int p_height, int p_threads) {
+	const int row_stride = p_width * 4;
+
+	// Rows holding pixels rjm_texbleed bleeds from, and whether anything
+	// needs filling at all.
+	std::vector<int> seed_rows(p_height + 1, 0);
+	bool any_transparent = false;
+	for (int y = 0; y < p_height; y++) {
+		const unsigned char *row = p_pixels + y * row_stride;
+		bool has_seed = false;
+		for (int x = 0; x < p_width; x++) {
+			const unsigned char alpha = row[x * 4 + 3];
+			has_seed = has_seed || alpha > BLEED_THRESHOLD;
+			any_transparent = any_transparent || alpha == 0;
+		}
+		seed_rows[y + 1] = seed_rows[y] + has_seed;
+	}
+	if (!any_transparent || seed_rows[p_height] == 0) {
+		return false;
+	}
+
+	const int threads = p_threads > 0 ? p_threads : ThreadWorkPool::get_default_thread_count();
+	const int band_height = std::max((p_height + threads - 1) / threads, TEXBLEED_MIN_BAND_HEIGHT);
+	const int band_count = (p_height + band_height - 1) / band_height;
+	if (band_count <= 1) {
+		rjm_texbleed(p_pixels, p_width, p_height, 3, 4, row_stride);
+		return true;
+	}
+
+	// Bands read their window from the source and write their own rows to a
+	// separate output, so no band sees another band's results.
+	std::vector<unsigned char> result(p_pixels, p_pixels + (size_t)row_stride * p_height);
+	ThreadWorkPool::do_work(band_count, threads, [&](int band) {
+		const int band_begin = band * band_height;
+		const int band_end = std::min(band_begin + band_height, p_height);
+		int begin;
+		int end;
+		_get_band_window(seed_rows, band_begin, band_end, begin, end);
+		std::vector<unsigned char> window(p_pixels + (size_t)begin * row_stride, p_pixels + (size_t)end * row_stride);
+		rjm_texbleed(window.data(), p_width, end - begin, 3, 4, row_stride);
+		memcpy(result.data() + (size_t)band_begin * row_stride, window.data() + (size_t)(band_begin - begin) * row_stride, (size_t)(band_end - band_begin) * row_stride);
+	});
+	memcpy(p_pixels, result.data(), result.size());
+	return true;
+}
@@ -0,0 +1,47 @@
+/*************************************************************************/
+/*  gltf_texture_bleed.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GLTF_TEXTURE_BLEED_H
+#define GLTF_TEXTURE_BLEED_H
+
+// Fills the RGB of fully transparent pixels of an RGBA8 image with the color
+// of the nearest opaque pixel (see rjm_texbleed), so mipmapping and filtering
+// don't pull in black or garbage colors.
+//
+// The image is split into horizontal bands processed on up to p_threads
+// workers (0 picks the hardware concurrency). Each band also reads a margin
+// of the neighbouring bands, a pixel further than that from any opaque pixel
+// in its window may pick a slightly farther source than a single pass would.
+// Bands without an opaque pixel in reach read up to the closest ones instead.
+// Returns false when there was nothing to do: no transparent pixels, or no
+// opaque pixel to bleed from.
+bool gltf_texture_bleed(unsigned char *p_pixels, int p_width, int p_height, int p_threads);
+
+#endif // GLTF_TEXTURE_BLEED_H
@@ -0,0 +1,95 @@
+/*************************************************************************/
+/*  gltf_texture_cache.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gltf_texture_cache.h"
+#include "gltf_hash.h"
+
+static void _write_u32(uint8_t *p_dst, uint32_t p_value) {
+	for (int i = 0; i < 4; i++) {
+		p_dst[i] = (p_value >> (i * 8)) & 0xff;
+	}
+}
+
+static void _write_u64(uint8_t *p_dst, uint64_t p_value) {
+	for (int i = 0; i < 8; i++) {
+		p_dst[i] = (p_value >> (i * 8)) & 0xff;
+	}
+}
+
+static uint32_t _read_u32(const uint8_t *p_src) {
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++) {
+		value |= (uint32_t)p_src[i] << (i * 8);
+	}
+	return value;
+}
+
+static uint64_t _read_u64(const uint8_t *p_src) {
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++) {
+		value |= (uint64_t)p_src[i] << (i * 8);
+	}
+	return value;
+}
+
+void gltf_texture_cache_write_header(const GLTFTextureCacheEntry &p_entry, uint8_t r_header[GLTF_TEXTURE_CACHE_HEADER_SIZE]) {
+	_write_u32(r_header + 0, GLTF_TEXTURE_CACHE_MAGIC);
+	_write_u32(r_header + 4, GLTF_TEXTURE_CACHE_VERSION);
+	_write_u32(r_header + 8, p_entry.width);
+	_write_u32(r_header + 12, p_entry.height);
+	r_header[16] = p_entry.mipmaps ? 1 : 0;
+	_write_u32(r_header + 17, p_entry.format);
+	_write_u32(r_header + 21, p_entry.data_size);
+	_write_u64(r_header + 25, gltf_hash_bytes(p_entry.data, p_entry.data_size, gltf_hash_bytes(r_header, 25)));
+}
+
+bool gltf_texture_cache_read(const uint8_t *p_file, size_t p_size, GLTFTextureCacheEntry &r_entry) {
+	if (p_size < GLTF_TEXTURE_CACHE_HEADER_SIZE) {
+		return false;
+	}
+	if (_read_u32(p_file + 0) != GLTF_TEXTURE_CACHE_MAGIC || _read_u32(p_file + 4) != GLTF_TEXTURE_CACHE_VERSION) {
+		return false;
+	}
+	GLTFTextureCacheEntry entry;
+	entry.width = _read_u32(p_file + 8);
+	entry.height = _read_u32(p_file + 12);
+	entry.mipmaps = p_file[16] != 0;
+	entry.format = _read_u32(p_file + 17);
+	entry.data_size = _read_u32(p_file + 21);
+	entry.data = p_file + GLTF_TEXTURE_CACHE_HEADER_SIZE;
+	if (entry.width == 0 || entry.height == 0 || p_file[16] > 1 || entry.data_size != p_size - GLTF_TEXTURE_CACHE_HEADER_SIZE) {
+		return false;
+	}
+	if (gltf_hash_bytes(entry.data, entry.data_size, gltf_hash_bytes(p_file, 25)) != _read_u64(p_file + 25)) {
+		return false;
+	}
+	r_entry = entry;
+	return true;
+}
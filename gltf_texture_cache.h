@@ -0,0 +1,61 @@
+/*************************************************************************/
+/*  gltf_texture_cache.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GLTF_TEXTURE_CACHE_H
+#define GLTF_TEXTURE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// On-disk format of the texture cache: a fixed little-endian header followed
+// by the raw Image data. The header ends with a hash of everything else, so
+// truncated or damaged entries are rejected instead of uploaded.
+static const uint32_t GLTF_TEXTURE_CACHE_MAGIC = 0x49544c47; // "GLTI"
+static const uint32_t GLTF_TEXTURE_CACHE_VERSION = 2;
+static const size_t GLTF_TEXTURE_CACHE_HEADER_SIZE = 33;
+
+struct GLTFTextureCacheEntry {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	bool mipmaps = false;
+	uint32_t format = 0;
+	const uint8_t *data = nullptr;
+	uint32_t data_size = 0;
+};
+
+// Writes the header for p_entry, whose data follows it in the file.
+void gltf_texture_cache_write_header(const GLTFTextureCacheEntry &p_entry, uint8_t r_header[GLTF_TEXTURE_CACHE_HEADER_SIZE]);
+
+// Parses a whole cache file. On success r_entry.data points into p_file.
+// Fails for other versions, empty images and data that is short, long or
+// doesn't match its hash.
+bool gltf_texture_cache_read(const uint8_t *p_file, size_t p_size, GLTFTextureCacheEntry &r_entry);
+
+#endif // GLTF_TEXTURE_CACHE_H
@@ -0,0 +1,488 @@
+/*************************************************************************/
+/*  mesh_simplifier.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "mesh_simplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+enum VertexKind {
+	KIND_MANIFOLD,
+	KIND_BORDER,
+	KIND_SEAM,
+	KIND_LOCKED,
+};
+
+// Which kinds of vertex may be collapsed onto which, indexed [from][to].
+const bool CAN_COLLAPSE[4][4] = {
+	{ true, true, true, true },
+	{ false, true, false, true },
+	{ false, false, true, true },
+	{ false, false, false, false },
+};
+
+// Border edges are weighted up so open boundaries keep their silhouette.
+const double BORDER_WEIGHT = 10.0;
+
+// Symmetric 4x4 matrix of a sum of planes (a, b, c, d) and the total weight
+// of those planes, so the error can be normalized to a squared distance.
+struct Quadric {
+	double a2 = 0, b2 = 0, c2 = 0, d2 = 0;
+	double ab = 0, ac = 0, ad = 0, bc = 0, bd = 0, cd = 0;
+	double w = 0;
+
+	void add_plane(double a, double b, double c, double d, double weight) {
+		a2 += a * a * weight;
+		b2 += b * b * weight;
+		c2 += c * c * weight;
+		d2 += d * d * weight;
+		ab += a * b * weight;
+		ac += a * c * weight;
+		ad += a * d * weight;
+		bc += b * c * weight;
+		bd += b * d * weight;
+		cd += c * d * weight;
+		w += weight;
+	}
+
+	void add(const Quadric &q) {
+		a2 += q.a2;
+		b2 += q.b2;
+		c2 += q.c2;
+		d2 += q.d2;
+		ab += q.ab;
+		ac += q.ac;
+		ad += q.ad;
+		bc += q.bc;
+		bd += q.bd;
+		cd += q.cd;
+		w += q.w;
+	}
+
+	double error(const float *v) const {
+		const double x = v[0], y = v[1], z = v[2];
+		const double rx = a2 * x + ab * y + ac * z;
+		const double ry = ab * x + b2 * y + bc * z;
+		const double rz = ac * x + bc * y + c2 * z;
+		const double e = rx * x + ry * y + rz * z + 2.0 * (ad * x + bd * y + cd * z) + d2;
+		return w > 0 ? std::fabs(e) / w : 0.0;
+	}
+};
+
+struct Collapse {
+	int from;
+	int to;
+	float cost;
+};
+
+inline void cross(const float *u, const float *v, double *r) {
+	r[0] = (double)u[1] * v[2] - (double)u[2] * v[1];
+	r[1] = (double)u[2] * v[0] - (double)u[0] * v[2];
+	r[2] = (double)u[0] * v[1] - (double)u[1] * v[0];
+}
+
+inline void triangle_normal(const float *p0, const float *p1, const float *p2, double *r) {
+	const float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+	const float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+	cross(e0, e1, r);
+}
+
+inline uint64_t edge_key(int a, int b) {
+	return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+}
+
+// Triangle lists per vertex, rebuilt at the start of every pass.
+struct Adjacency {
+	std::vector<int> offsets;
+	std::vector<int> triangles;
+
+	void build(const std::vector<int> &p_indices, int p_vertex_count) {
+		offsets.assign(p_vertex_count + 1, 0);
+		for (size_t i = 0; i < p_indices.size(); i++) {
+			offsets[p_indices[i] + 1]++;
+		}
+		for (int i = 0; i < p_vertex_count; i++) {
+			offsets[i + 1] += offsets[i];
+		}
+		triangles.resize(p_indices.size());
+		std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < p_indices.size(); i++) {
+			triangles[fill[p_indices[i]]++] = (int)(i / 3);
+		}
+	}
+};
+
+} // namespace
+
+float MeshSimplifier::simplify(const float *p_positions, int p_vertex_count,
+		const std::vector<int> &p_indices, int p_target_index_count,
+		float p_target_error, const std::vector<Attribute> &p_attributes,
+		const std::vector<int> &p_groups, std::vector<int> &r_indices) {
+	r_indices = p_indices;
+	if (p_vertex_count == 0 || p_indices.size() % 3 != 0 || (int)p_indices.size() <= p_target_index_count) {
+		return 0.0f;
+	}
+
+	// Work in a unit cube so the error limit is independent of scale.
+	float min[3] = { p_positions[0], p_positions[1], p_positions[2] };
+	float max[3] = { min[0], min[1], min[2] };
+	for (int i = 1; i < p_vertex_count; i++) {
+		for (int j = 0; j < 3; j++) {
+			min[j] = std::min(min[j], p_positions[i * 3 + j]);
+			max[j] = std::max(max[j], p_positions[i * 3 + j]);
+		}
+	}
+	const float extent = std::max(max[0] - min[0], std::max(max[1] - min[1], max[2] - min[2]));
+	const float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+	std::vector<float> positions(p_vertex_count * 3);
+	for (int i = 0; i < p_vertex_count * 3; i++) {
+		positions[i] = (p_positions[i] - min[i % 3]) * scale;
+	}
+
+	// Vertices sharing a position form a ring of wedges; remap points every
+	// wedge at the first one, which stands for the position as a whole.
+	std::vector<int> remap(p_vertex_count);
+	std::vector<int> wedge(p_vertex_count);
+	{
+		std::vector<int> order(p_vertex_count);
+		for (int i = 0; i < p_vertex_count; i++) {
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&](int a, int b) {
+			const float *pa = &p_positions[a * 3];
+			const float *pb = &p_positions[b * 3];
+			if (pa[0] != pb[0]) {
+				return pa[0] < pb[0];
+			}
+			if (pa[1] != pb[1]) {
+				return pa[1] < pb[1];
+			}
+			if (pa[2] != pb[2]) {
+				return pa[2] < pb[2];
+			}
+			return a < b;
+		});
+		int start = 0;
+		for (int i = 1; i <= p_vertex_count; i++) {
+			if (i < p_vertex_count) {
+				const float *pa = &p_positions[order[start] * 3];
+				const float *pb = &p_positions[order[i] * 3];
+				if (pa[0] == pb[0] && pa[1] == pb[1] && pa[2] == pb[2]) {
+					continue;
+				}
+			}
+			for (int j = start; j < i; j++) {
+				remap[order[j]] = order[start];
+				wedge[order[j]] = order[j + 1 < i ? j + 1 : start];
+			}
+			start = i;
+		}
+	}
+
+	// Drop triangles that are degenerate in position space up front, they
+	// would otherwise block every collapse around them.
+	std::vector<int> indices;
+	indices.reserve(p_indices.size());
+	for (size_t i = 0; i < p_indices.size(); i += 3) {
+		const int a = p_indices[i], b = p_indices[i + 1], c = p_indices[i + 2];
+		if (remap[a] != remap[b] && remap[b] != remap[c] && remap[c] != remap[a]) {
+			indices.push_back(a);
+			indices.push_back(b);
+			indices.push_back(c);
+		}
+	}
+
+	// An edge is open when no triangle walks it in the opposite direction.
+	std::vector<uint64_t> edges;
+	edges.reserve(indices.size());
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		for (int e = 0; e < 3; e++) {
+			edges.push_back(edge_key(remap[indices[i + e]], remap[indices[i + (e + 1) % 3]]));
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+	auto has_edge = [&](int a, int b) {
+		return std::binary_search(edges.begin(), edges.end(), edge_key(a, b));
+	};
+
+	std::vector<int> open_out(p_vertex_count, 0);
+	std::vector<int> open_in(p_vertex_count, 0);
+	std::vector<Quadric> quadrics(p_vertex_count);
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const float *p[3] = {
+			&positions[indices[i] * 3],
+			&positions[indices[i + 1] * 3],
+			&positions[indices[i + 2] * 3],
+		};
+		double n[3];
+		triangle_normal(p[0], p[1], p[2], n);
+		const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length == 0.0) {
+			continue;
+		}
+		n[0] /= length;
+		n[1] /= length;
+		n[2] /= length;
+		const double d = -(n[0] * p[0][0] + n[1] * p[0][1] + n[2] * p[0][2]);
+		for (int e = 0; e < 3; e++) {
+			quadrics[remap[indices[i + e]]].add_plane(n[0], n[1], n[2], d, length * 0.5);
+		}
+
+		for (int e = 0; e < 3; e++) {
+			const int a = remap[indices[i + e]];
+			const int b = remap[indices[i + (e + 1) % 3]];
+			if (has_edge(b, a)) {
+				continue;
+			}
+			open_out[a]++;
+			open_in[b]++;
+			// Plane through the edge, perpendicular to the triangle.
+			const float *pa = &positions[a * 3];
+			const float *pb = &positions[b * 3];
+			const float dir[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+			const float nf[3] = { (float)n[0], (float)n[1], (float)n[2] };
+			double en[3];
+			cross(dir, nf, en);
+			const double elength = std::sqrt(en[0] * en[0] + en[1] * en[1] + en[2] * en[2]);
+			if (elength == 0.0) {
+				continue;
+			}
+			en[0] /= elength;
+			en[1] /= elength;
+			en[2] /= elength;
+			const double ed = -(en[0] * pa[0] + en[1] * pa[1] + en[2] * pa[2]);
+			const double weight = (dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]) * BORDER_WEIGHT;
+			quadrics[a].add_plane(en[0], en[1], en[2], ed, weight);
+			quadrics[b].add_plane(en[0], en[1], en[2], ed, weight);
+		}
+	}
+
+	std::vector<unsigned char> kinds(p_vertex_count, KIND_LOCKED);
+	for (int i = 0; i < p_vertex_count; i++) {
+		if (remap[i] != i) {
+			continue;
+		}
+		int wedges = 1;
+		for (int w = wedge[i]; w != i; w = wedge[w]) {
+			wedges++;
+		}
+		if (open_out[i] == 0 && open_in[i] == 0) {
+			kinds[i] = wedges == 1 ? KIND_MANIFOLD : (wedges == 2 ? KIND_SEAM : KIND_LOCKED);
+		} else if (open_out[i] == 1 && open_in[i] == 1 && wedges == 1) {
+			kinds[i] = KIND_BORDER;
+		}
+	}
+
+	auto attribute_cost = [&](int a, int b) {
+		double cost = 0.0;
+		for (size_t i = 0; i < p_attributes.size(); i++) {
+			const Attribute &attribute = p_attributes[i];
+			const float *va = attribute.data + (size_t)a * attribute.components;
+			const float *vb = attribute.data + (size_t)b * attribute.components;
+			double sum = 0.0;
+			for (int c = 0; c < attribute.components; c++) {
+				const double delta = va[c] - vb[c];
+				sum += delta * delta;
+			}
+			cost += sum * attribute.weight;
+		}
+		return cost;
+	};
+
+	auto same_group = [&](int a, int b) {
+		return p_groups.empty() || p_groups[a] == p_groups[b];
+	};
+
+	const double error_limit = (double)p_target_error * p_target_error;
+	double result_error = 0.0;
+	Adjacency adjacency;
+	std::vector<Collapse> collapses;
+	std::vector<int> collapse_remap(p_vertex_count);
+	std::vector<unsigned char> locked(p_vertex_count);
+	std::vector<int> wedge_targets;
+
+	while ((int)indices.size() > p_target_index_count) {
+		adjacency.build(indices, p_vertex_count);
+
+		collapses.clear();
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (int e = 0; e < 3; e++) {
+				const int v0 = indices[i + e];
+				const int v1 = indices[i + (e + 1) % 3];
+				for (int dir = 0; dir < 2; dir++) {
+					const int from = dir ? v1 : v0;
+					const int to = dir ? v0 : v1;
+					const int a = remap[from];
+					const int b = remap[to];
+					if (!CAN_COLLAPSE[kinds[a]][kinds[b]] || !same_group(from, to)) {
+						continue;
+					}
+					if (kinds[a] == KIND_BORDER && has_edge(a, b) == has_edge(b, a)) {
+						continue; // Borders only slide along themselves.
+					}
+					const double cost = quadrics[a].error(&positions[b * 3]) + attribute_cost(from, to);
+					if (cost <= error_limit) {
+						collapses.push_back({ from, to, (float)cost });
+					}
+				}
+			}
+		}
+		if (collapses.empty()) {
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y) {
+			return x.cost < y.cost;
+		});
+
+		for (int i = 0; i < p_vertex_count; i++) {
+			collapse_remap[i] = i;
+		}
+		std::fill(locked.begin(), locked.end(), 0);
+		const int triangles_needed = ((int)indices.size() - p_target_index_count + 2) / 3;
+		int triangles_removed = 0;
+		int applied = 0;
+
+		for (size_t c = 0; c < collapses.size() && triangles_removed < triangles_needed; c++) {
+			const Collapse &collapse = collapses[c];
+			const int a = remap[collapse.from];
+			const int b = remap[collapse.to];
+			if (locked[a] || locked[b]) {
+				continue;
+			}
+
+			// Every wedge of a must land on a wedge of b in its group that it
+			// shares a triangle with, otherwise the collapse would tear a
+			// seam open.
+			bool valid = true;
+			wedge_targets.clear();
+			int w = a;
+			do {
+				int target = w == collapse.from ? collapse.to : -1;
+				for (int t = adjacency.offsets[w]; target < 0 && t < adjacency.offsets[w + 1]; t++) {
+					const int *tri = &indices[adjacency.triangles[t] * 3];
+					for (int k = 0; k < 3; k++) {
+						if (remap[tri[k]] == b && same_group(w, tri[k])) {
+							target = tri[k];
+							break;
+						}
+					}
+				}
+				if (target < 0) {
+					valid = false;
+					break;
+				}
+				wedge_targets.push_back(target);
+				w = wedge[w];
+			} while (w != a);
+			if (!valid) {
+				continue;
+			}
+
+			// Reject collapses that flip any surviving triangle around a.
+			const float *pb = &positions[b * 3];
+			w = a;
+			do {
+				for (int t = adjacency.offsets[w]; valid && t < adjacency.offsets[w + 1]; t++) {
+					const int *tri = &indices[adjacency.triangles[t] * 3];
+					int corner = -1;
+					bool collapses_away = false;
+					for (int k = 0; k < 3; k++) {
+						if (tri[k] == w) {
+							corner = k;
+						} else if (remap[tri[k]] == b) {
+							collapses_away = true;
+						}
+					}
+					if (collapses_away || corner < 0) {
+						continue;
+					}
+					const float *p1 = &positions[tri[(corner + 1) % 3] * 3];
+					const float *p2 = &positions[tri[(corner + 2) % 3] * 3];
+					double before[3], after[3];
+					triangle_normal(&positions[w * 3], p1, p2, before);
+					triangle_normal(pb, p1, p2, after);
+					const double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+					if (dot <= 0.0) {
+						valid = false;
+					}
+				}
+				w = wedge[w];
+			} while (valid && w != a);
+			if (!valid) {
+				continue;
+			}
+
+			int k = 0;
+			w = a;
+			do {
+				collapse_remap[w] = wedge_targets[k++];
+				// Lock the one-ring: its triangles change shape this pass.
+				for (int t = adjacency.offsets[w]; t < adjacency.offsets[w + 1]; t++) {
+					const int *tri = &indices[adjacency.triangles[t] * 3];
+					locked[remap[tri[0]]] = 1;
+					locked[remap[tri[1]]] = 1;
+					locked[remap[tri[2]]] = 1;
+				}
+				w = wedge[w];
+			} while (w != a);
+			locked[a] = 1;
+			locked[b] = 1;
+
+			quadrics[b].add(quadrics[a]);
+			result_error = std::max(result_error, (double)collapse.cost);
+			triangles_removed += kinds[a] == KIND_BORDER ? 1 : 2;
+			applied++;
+		}
+		if (applied == 0) {
+			break;
+		}
+
+		size_t write = 0;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const int a = collapse_remap[indices[i]];
+			const int b = collapse_remap[indices[i + 1]];
+			const int c = collapse_remap[indices[i + 2]];
+			if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a]) {
+				continue;
+			}
+			indices[write++] = a;
+			indices[write++] = b;
+			indices[write++] = c;
+		}
+		indices.resize(write);
+	}
+
+	r_indices.swap(indices);
+	return (float)std::sqrt(result_error) * (extent > 0.0f ? extent : 1.0f);
+}
@@ -0,0 +1,65 @@
+/*************************************************************************/
+/*  mesh_simplifier.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+
+// Quadric error metric edge-collapse simplifier for indexed triangle lists.
+//
+// The simplifier never creates new vertices: every collapse moves a vertex onto
+// one of its neighbours, so the output indices reference the input vertex
+// arrays unchanged and all attributes (normals, UVs, skin weights) are kept
+// exactly. Vertices sharing a position but not their attributes ("wedges") are
+// treated as UV/normal seams and may only slide along the seam, open borders
+// may only slide along the border, and anything more complex is locked.
+class MeshSimplifier {
+public:
+	struct Attribute {
+		const float *data = nullptr;
+		int components = 0;
+		float weight = 0.0f;
+	};
+
+	// Simplifies p_indices (a triangle list over p_vertex_count xyz positions)
+	// towards p_target_index_count indices without exceeding p_target_error,
+	// which is relative to the mesh extent. Attribute differences between two
+	// collapsed vertices are added to the cost, scaled by their weights.
+	// Vertices are only collapsed onto vertices of the same group in
+	// p_groups, e.g. the same set of skin joints; empty puts all vertices in
+	// one group. Returns the error of the result in mesh units.
+	static float simplify(const float *p_positions, int p_vertex_count,
+			const std::vector<int> &p_indices, int p_target_index_count,
+			float p_target_error, const std::vector<Attribute> &p_attributes,
+			const std::vector<int> &p_groups, std::vector<int> &r_indices);
+};
+
+#endif // MESH_SIMPLIFIER_H
@@ -39,17 +39,21 @@
 #include "gltf_light.h"
 #include "gltf_mesh.h"
 #include "gltf_node.h"
+#include "gltf_resource_registry.h"
 #include "gltf_skeleton.h"
 #include "gltf_skin.h"
 #include "gltf_spec_gloss.h"
 #include "gltf_state.h"
 #include "gltf_texture.h"
+#include "thread_work_pool.h"
 
 extern "C" void GDN_EXPORT godot_gltf_gdnative_init(godot_gdnative_init_options *o) {
     godot::Godot::gdnative_init(o);
 }
 
 extern "C" void GDN_EXPORT godot_gltf_gdnative_terminate(godot_gdnative_terminate_options *o) {
+    GLTFResourceRegistry::clear();
+    ThreadWorkPool::finish();
     godot::Godot::gdnative_terminate(o);
 }
 
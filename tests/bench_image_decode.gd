@@ -0,0 +1,94 @@
+# Times image decoding at 2K, 4K and 8K with 1, 2, 4 and 8 worker threads,
+# as reported in import_stats. Each scene holds several textures so the
+# workers have images to share out.
+#
+# Run from a Godot 3 project holding the module's NativeScripts:
+#   godot --no-window -s res://tests/bench_image_decode.gd --gltf-scripts=res://gltf/
+extends SceneTree
+
+const SIZES = [2048, 4096, 8192]
+const THREADS = [1, 2, 4, 8]
+const IMAGES_PER_SCENE = 8
+const WORK_DIR = "user://bench_image_decode"
+
+
+func _get_script_dir():
+	for arg in OS.get_cmdline_args():
+		if arg.begins_with("--gltf-scripts="):
+			return arg.split("=")[1]
+	return "res://gltf/"
+
+
+func _make_image(p_size):
+	var image = Image.new()
+	image.create(p_size, p_size, false, Image.FORMAT_RGBA8)
+	var rng = RandomNumberGenerator.new()
+	rng.seed = p_size
+	image.lock()
+	# Blocks of random color keep the PNGs small without making rows uniform.
+	for y in range(0, p_size, 16):
+		for x in range(0, p_size, 16):
+			image.fill_rect(Rect2(x, y, 16, 16), Color(rng.randf(), rng.randf(), rng.randf(), 1.0))
+	image.unlock()
+	return image
+
+
+func _write_scene(p_size):
+	var path = WORK_DIR.plus_file("decode_%d.gltf" % p_size)
+	var first_image = WORK_DIR.plus_file("image_%d_0.png" % p_size)
+	_make_image(p_size).save_png(first_image)
+
+	var textures = []
+	var images = []
+	var dir = Directory.new()
+	for i in range(IMAGES_PER_SCENE):
+		# Separate files, so no image is skipped as a duplicate of another.
+		var name = "image_%d_%d.png" % [p_size, i]
+		if i > 0:
+			dir.copy(first_image, WORK_DIR.plus_file(name))
+		textures.append({ "source": i })
+		images.append({ "uri": name })
+
+	var materials = []
+	for i in range(IMAGES_PER_SCENE):
+		materials.append({ "pbrMetallicRoughness": { "baseColorTexture": { "index": i } } })
+	var json = {
+		"asset": { "version": "2.0" },
+		"scene": 0,
+		"scenes": [{ "nodes": [0] }],
+		"nodes": [{ "name": "Root" }],
+		"materials": materials,
+		"textures": textures,
+		"images": images,
+	}
+	var file = File.new()
+	file.open(path, File.WRITE)
+	file.store_string(JSON.print(json))
+	file.close()
+	return path
+
+
+func _init():
+	var script_dir = _get_script_dir()
+	var state_script = load(script_dir.plus_file("gltf_state.gdns"))
+	var importer = load(script_dir.plus_file("packed_scene_gltf.gdns")).new()
+	Directory.new().make_dir_recursive(WORK_DIR)
+
+	print("%6s %8s %12s %9s" % ["size", "threads", "msec", "speedup"])
+	for size in SIZES:
+		var path = _write_scene(size)
+		var base_msec = 0.0
+		for threads in THREADS:
+			var state = state_script.new()
+			state.worker_thread_count = threads
+			var root = importer.import_gltf_scene(path, PoolByteArray(), 0, 30, state)
+			if root == null:
+				printerr("Failed to import " + path)
+				quit(1)
+				return
+			root.free()
+			var msec = state.import_stats["images"]["decode_msec"]
+			if threads == THREADS[0]:
+				base_msec = msec
+			print("%6d %8d %12.1f %8.2fx" % [size, threads, msec, base_msec / max(msec, 0.001)])
+	quit(0)
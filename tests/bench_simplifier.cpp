@@ -0,0 +1,106 @@
+// Times LOD generation for a million vertex mesh: the default 1/2, 1/4 and
+// 1/8 chain on one surface, then the same mesh split into 8 surfaces
+// simplified on 1, 2, 4 and 8 workers like the importer does.
+//   g++ -std=c++14 -O2 -pthread -I. tests/bench_simplifier.cpp mesh_simplifier.cpp -o bench_simplifier && ./bench_simplifier
+
+#include "mesh_simplifier.h"
+#include "thread_work_pool.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+static const int GRID_SIZE = 1000;
+static const float LOD_RATIOS[] = { 0.5f, 0.25f, 0.125f };
+static const float TARGET_ERROR = 0.02f;
+static const int THREADS[] = { 1, 2, 4, 8 };
+static const int SURFACES = 8;
+
+struct Surface {
+	std::vector<float> positions;
+	std::vector<float> normals;
+	std::vector<float> uvs;
+	std::vector<int> indices;
+};
+
+static double _now_msec() {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A rolling height field over rows [p_row_begin, p_row_end] of the grid.
+static Surface _make_surface(int p_row_begin, int p_row_end) {
+	Surface surface;
+	const int rows = p_row_end - p_row_begin + 1;
+	for (int y = p_row_begin; y <= p_row_end; y++) {
+		for (int x = 0; x < GRID_SIZE; x++) {
+			const float u = (float)x / (GRID_SIZE - 1);
+			const float v = (float)y / (GRID_SIZE - 1);
+			const float height = 0.05f * sinf(u * 12.0f) * cosf(v * 9.0f);
+			surface.positions.insert(surface.positions.end(), { u, height, v });
+			const float dx = 0.05f * 12.0f * cosf(u * 12.0f) * cosf(v * 9.0f);
+			const float dz = -0.05f * 9.0f * sinf(u * 12.0f) * sinf(v * 9.0f);
+			const float length = sqrtf(dx * dx + 1.0f + dz * dz);
+			surface.normals.insert(surface.normals.end(), { -dx / length, 1.0f / length, -dz / length });
+			surface.uvs.insert(surface.uvs.end(), { u, v });
+		}
+	}
+	for (int y = 0; y + 1 < rows; y++) {
+		for (int x = 0; x + 1 < GRID_SIZE; x++) {
+			const int i = y * GRID_SIZE + x;
+			surface.indices.insert(surface.indices.end(), { i, i + GRID_SIZE, i + 1, i + 1, i + GRID_SIZE, i + GRID_SIZE + 1 });
+		}
+	}
+	return surface;
+}
+
+// Returns the triangle count of each level.
+static std::vector<int> _simplify_chain(const Surface &p_surface) {
+	std::vector<MeshSimplifier::Attribute> attributes;
+	attributes.push_back({ p_surface.normals.data(), 3, 0.01f });
+	attributes.push_back({ p_surface.uvs.data(), 2, 0.01f });
+	std::vector<int> triangles;
+	std::vector<int> level;
+	const std::vector<int> *source = &p_surface.indices;
+	std::vector<int> previous;
+	for (size_t level_i = 0; level_i < sizeof(LOD_RATIOS) / sizeof(LOD_RATIOS[0]); level_i++) {
+		const int target = int(p_surface.indices.size() / 3 * LOD_RATIOS[level_i]) * 3;
+		MeshSimplifier::simplify(p_surface.positions.data(), p_surface.positions.size() / 3, *source, target, TARGET_ERROR,
+				attributes, std::vector<int>(), level);
+		triangles.push_back(level.size() / 3);
+		previous.swap(level);
+		source = &previous;
+	}
+	return triangles;
+}
+
+int main() {
+	const Surface surface = _make_surface(0, GRID_SIZE - 1);
+	printf("single surface: %d vertices, %d triangles\n", (int)surface.positions.size() / 3, (int)surface.indices.size() / 3);
+	double begin = _now_msec();
+	const std::vector<int> triangles = _simplify_chain(surface);
+	printf("  chain in %.1f ms, levels:", _now_msec() - begin);
+	for (size_t i = 0; i < triangles.size(); i++) {
+		printf(" %d", triangles[i]);
+	}
+	printf(" triangles\n");
+
+	std::vector<Surface> surfaces;
+	const int rows_per_surface = (GRID_SIZE - 1) / SURFACES;
+	for (int i = 0; i < SURFACES; i++) {
+		const int row_end = i + 1 == SURFACES ? GRID_SIZE - 1 : (i + 1) * rows_per_surface;
+		surfaces.push_back(_make_surface(i * rows_per_surface, row_end));
+	}
+	printf("%d surfaces:\n%8s %12s %9s\n", SURFACES, "threads", "msec", "speedup");
+	double base_msec = 0.0;
+	for (size_t thread_i = 0; thread_i < sizeof(THREADS) / sizeof(THREADS[0]); thread_i++) {
+		begin = _now_msec();
+		ThreadWorkPool::do_work(surfaces.size(), THREADS[thread_i], [&](int p_index) {
+			_simplify_chain(surfaces[p_index]);
+		});
+		const double msec = _now_msec() - begin;
+		base_msec = thread_i == 0 ? msec : base_msec;
+		printf("%8d %12.1f %8.2fx\n", THREADS[thread_i], msec, base_msec / msec);
+	}
+	return 0;
+}
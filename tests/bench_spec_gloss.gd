@@ -0,0 +1,94 @@
+# Times the KHR_materials_pbrSpecularGlossiness conversion at 2K, 4K and 8K
+# with 1, 2, 4 and 8 worker threads, as reported in import_stats.
+#
+# Run from a Godot 3 project holding the module's NativeScripts:
+#   godot --no-window -s res://tests/bench_spec_gloss.gd --gltf-scripts=res://gltf/
+extends SceneTree
+
+const SIZES = [2048, 4096, 8192]
+const THREADS = [1, 2, 4, 8]
+const WORK_DIR = "user://bench_spec_gloss"
+
+
+func _get_script_dir():
+	for arg in OS.get_cmdline_args():
+		if arg.begins_with("--gltf-scripts="):
+			return arg.split("=")[1]
+	return "res://gltf/"
+
+
+func _make_image(p_size, p_seed):
+	var image = Image.new()
+	image.create(p_size, p_size, false, Image.FORMAT_RGBA8)
+	var rng = RandomNumberGenerator.new()
+	rng.seed = p_seed
+	image.lock()
+	# Blocks of random color keep the PNGs small without making rows uniform.
+	for y in range(0, p_size, 16):
+		for x in range(0, p_size, 16):
+			image.fill_rect(Rect2(x, y, 16, 16), Color(rng.randf(), rng.randf(), rng.randf(), rng.randf()))
+	image.unlock()
+	return image
+
+
+func _write_scene(p_size):
+	var path = WORK_DIR.plus_file("spec_gloss_%d.gltf" % p_size)
+	_make_image(p_size, 1).save_png(WORK_DIR.plus_file("diffuse_%d.png" % p_size))
+	_make_image(p_size, 2).save_png(WORK_DIR.plus_file("spec_gloss_%d.png" % p_size))
+
+	var positions = PoolRealArray([0, 0, 0, 1, 0, 0, 0, 1, 0])
+	var uvs = PoolRealArray([0, 0, 1, 0, 0, 1])
+	var buffer = StreamPeerBuffer.new()
+	for value in positions + uvs:
+		buffer.put_float(value)
+	var json = {
+		"asset": { "version": "2.0" },
+		"extensionsUsed": ["KHR_materials_pbrSpecularGlossiness"],
+		"scene": 0,
+		"scenes": [{ "nodes": [0] }],
+		"nodes": [{ "mesh": 0 }],
+		"meshes": [{ "primitives": [{ "attributes": { "POSITION": 0, "TEXCOORD_0": 1 }, "material": 0 }] }],
+		"materials": [{ "extensions": { "KHR_materials_pbrSpecularGlossiness": {
+			"diffuseTexture": { "index": 0 },
+			"specularGlossinessTexture": { "index": 1 },
+		} } }],
+		"textures": [{ "source": 0 }, { "source": 1 }],
+		"images": [{ "uri": "diffuse_%d.png" % p_size }, { "uri": "spec_gloss_%d.png" % p_size }],
+		"buffers": [{ "byteLength": buffer.get_size(), "uri": "data:application/octet-stream;base64," + Marshalls.raw_to_base64(buffer.data_array) }],
+		"bufferViews": [{ "buffer": 0, "byteLength": 36 }, { "buffer": 0, "byteOffset": 36, "byteLength": 24 }],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3", "min": [0, 0, 0], "max": [1, 1, 0] },
+			{ "bufferView": 1, "componentType": 5126, "count": 3, "type": "VEC2" },
+		],
+	}
+	var file = File.new()
+	file.open(path, File.WRITE)
+	file.store_string(JSON.print(json))
+	file.close()
+	return path
+
+
+func _init():
+	var script_dir = _get_script_dir()
+	var state_script = load(script_dir.plus_file("gltf_state.gdns"))
+	var importer = load(script_dir.plus_file("packed_scene_gltf.gdns")).new()
+	Directory.new().make_dir_recursive(WORK_DIR)
+
+	print("%6s %8s %12s %9s" % ["size", "threads", "msec", "speedup"])
+	for size in SIZES:
+		var path = _write_scene(size)
+		var base_msec = 0.0
+		for threads in THREADS:
+			var state = state_script.new()
+			state.worker_thread_count = threads
+			var root = importer.import_gltf_scene(path, PoolByteArray(), 0, 30, state)
+			if root == null:
+				printerr("Failed to import " + path)
+				quit(1)
+				return
+			root.free()
+			var msec = state.import_stats["materials"]["spec_gloss_msec"]
+			if threads == THREADS[0]:
+				base_msec = msec
+			print("%6d %8d %12.1f %8.2fx" % [size, threads, msec, base_msec / max(msec, 0.001)])
+	quit(0)
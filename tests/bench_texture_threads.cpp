@@ -0,0 +1,80 @@
+// Times the threaded texture passes at 2K, 4K and 8K with 1, 2, 4 and 8
+// workers, plus the dispatch cost of ThreadWorkPool for small jobs.
+// Only the engine independent code is measured:
+//   g++ -std=c++14 -O2 -pthread -I. tests/bench_texture_threads.cpp gltf_mipmaps.cpp gltf_texture_bleed.cpp -o bench_texture_threads && ./bench_texture_threads
+
+#include "gltf_mipmaps.h"
+#include "gltf_texture_bleed.h"
+#include "thread_work_pool.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+static const int SIZES[] = { 2048, 4096, 8192 };
+static const int THREADS[] = { 1, 2, 4, 8 };
+
+static double _now_msec() {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Opaque noise with a transparent hole every few tiles, so bleeding has
+// both near and far pixels to fill.
+static void _fill_image(std::vector<unsigned char> &r_pixels, int p_size) {
+	uint32_t state = 0x12345678;
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			unsigned char *pixel = &r_pixels[((size_t)y * p_size + x) * 4];
+			state = state * 1664525 + 1013904223;
+			pixel[0] = state >> 24;
+			pixel[1] = state >> 16;
+			pixel[2] = state >> 8;
+			pixel[3] = ((x / 64) % 3 == 0 && (y / 64) % 3 == 0) ? 0 : 255;
+		}
+	}
+}
+
+int main() {
+	printf("%-10s %6s %8s %12s %12s\n", "pass", "size", "threads", "msec", "speedup");
+	for (size_t size_i = 0; size_i < sizeof(SIZES) / sizeof(SIZES[0]); size_i++) {
+		const int size = SIZES[size_i];
+		std::vector<unsigned char> source((size_t)size * size * 4);
+		_fill_image(source, size);
+		std::vector<unsigned char> pixels(gltf_mipmap_chain_size(size, size, 4));
+
+		double mipmap_base = 0.0;
+		double bleed_base = 0.0;
+		for (size_t thread_i = 0; thread_i < sizeof(THREADS) / sizeof(THREADS[0]); thread_i++) {
+			const int threads = THREADS[thread_i];
+
+			memcpy(pixels.data(), source.data(), source.size());
+			double begin = _now_msec();
+			gltf_generate_mipmaps(pixels.data(), size, size, 4, true, threads);
+			const double mipmap_msec = _now_msec() - begin;
+			mipmap_base = thread_i == 0 ? mipmap_msec : mipmap_base;
+			printf("%-10s %6d %8d %12.1f %11.2fx\n", "mipmaps", size, threads, mipmap_msec, mipmap_base / mipmap_msec);
+
+			memcpy(pixels.data(), source.data(), source.size());
+			begin = _now_msec();
+			gltf_texture_bleed(pixels.data(), size, size, threads);
+			const double bleed_msec = _now_msec() - begin;
+			bleed_base = thread_i == 0 ? bleed_msec : bleed_base;
+			printf("%-10s %6d %8d %12.1f %11.2fx\n", "bleed", size, threads, bleed_msec, bleed_base / bleed_msec);
+		}
+	}
+
+	// Many tiny jobs, like the mip levels of small textures.
+	const int rounds = 10000;
+	for (size_t thread_i = 0; thread_i < sizeof(THREADS) / sizeof(THREADS[0]); thread_i++) {
+		const int threads = THREADS[thread_i];
+		std::atomic<int> sum(0);
+		const double begin = _now_msec();
+		for (int round = 0; round < rounds; round++) {
+			ThreadWorkPool::do_work(16, threads, [&](int i) { sum += i; });
+		}
+		const double usec = (_now_msec() - begin) * 1000.0 / rounds;
+		printf("%-10s %6d %8d %10.2fus/call\n", "dispatch", 16, threads, usec);
+	}
+	return 0;
+}
@@ -0,0 +1,46 @@
+# Materials that only differ in their textures must stay apart when
+# deduplicate_materials is on.
+#
+# Run from a Godot 3 project holding the module's NativeScripts:
+#   godot --no-window -s res://tests/test_material_dedup.gd --gltf-scripts=res://gltf/
+extends SceneTree
+
+const FIXTURE = "res://tests/fixtures/materials_differing_textures.gltf"
+
+var failures = 0
+
+
+func _check(p_condition, p_message):
+	if not p_condition:
+		printerr("FAIL: " + p_message)
+		failures += 1
+
+
+func _get_script_dir():
+	for arg in OS.get_cmdline_args():
+		if arg.begins_with("--gltf-scripts="):
+			return arg.split("=")[1]
+	return "res://gltf/"
+
+
+func _init():
+	var script_dir = _get_script_dir()
+	var state = load(script_dir.plus_file("gltf_state.gdns")).new()
+	state.deduplicate_materials = true
+	var importer = load(script_dir.plus_file("packed_scene_gltf.gdns")).new()
+	var root = importer.import_gltf_scene(FIXTURE, PoolByteArray(), 0, 30, state)
+	_check(root != null, "the fixture imports")
+
+	var materials = state.materials
+	_check(materials.size() == 2, "both glTF materials are parsed")
+	if materials.size() == 2:
+		_check(materials[0] != materials[1], "materials with different textures are not merged")
+		var albedo_a = materials[0].albedo_texture
+		var albedo_b = materials[1].albedo_texture
+		_check(albedo_a != null and albedo_b != null and albedo_a != albedo_b, "each material keeps its own texture")
+	_check(state.import_stats["materials"]["unique"] == 2, "import_stats counts two unique materials")
+
+	if root:
+		root.free()
+	print("test_material_dedup: %s" % ("FAILED" if failures else "OK"))
+	quit(1 if failures else 0)
@@ -0,0 +1,94 @@
+// Texture cache entries must round trip and damaged ones must be rejected.
+// Only the file format is tested, so no engine is needed:
+//   g++ -std=c++14 -I. tests/test_texture_cache.cpp gltf_texture_cache.cpp -o test_texture_cache && ./test_texture_cache
+
+#include "gltf_texture_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+
+static void _check(bool p_condition, const char *p_message) {
+	if (!p_condition) {
+		fprintf(stderr, "FAIL: %s\n", p_message);
+		failures++;
+	}
+}
+
+static std::vector<uint8_t> _make_file(const std::vector<uint8_t> &p_data) {
+	GLTFTextureCacheEntry entry;
+	entry.width = 8;
+	entry.height = 4;
+	entry.mipmaps = true;
+	entry.format = 17;
+	entry.data = p_data.data();
+	entry.data_size = p_data.size();
+	std::vector<uint8_t> file(GLTF_TEXTURE_CACHE_HEADER_SIZE);
+	gltf_texture_cache_write_header(entry, file.data());
+	file.insert(file.end(), p_data.begin(), p_data.end());
+	return file;
+}
+
+// Goes through a real file, like the importer does.
+static std::vector<uint8_t> _store_and_reload(const std::vector<uint8_t> &p_file) {
+	const char *path = "test_texture_cache.gltfimg";
+	FILE *f = fopen(path, "wb");
+	if (!f) {
+		return std::vector<uint8_t>();
+	}
+	fwrite(p_file.data(), 1, p_file.size(), f);
+	fclose(f);
+
+	std::vector<uint8_t> loaded;
+	f = fopen(path, "rb");
+	if (f) {
+		uint8_t chunk[256];
+		size_t read;
+		while ((read = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+			loaded.insert(loaded.end(), chunk, chunk + read);
+		}
+		fclose(f);
+	}
+	remove(path);
+	return loaded;
+}
+
+int main() {
+	std::vector<uint8_t> data(8 * 4 * 4 + 4 * 2 * 4 + 2 * 1 * 4 + 4);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (i * 37 + 11) & 0xff;
+	}
+	const std::vector<uint8_t> file = _make_file(data);
+	const std::vector<uint8_t> loaded = _store_and_reload(file);
+	_check(loaded == file, "the entry is written and read back unchanged");
+
+	GLTFTextureCacheEntry entry;
+	_check(gltf_texture_cache_read(loaded.data(), loaded.size(), entry), "a stored entry is accepted");
+	_check(entry.width == 8 && entry.height == 4 && entry.mipmaps && entry.format == 17, "the image description round trips");
+	_check(entry.data_size == data.size() && memcmp(entry.data, data.data(), data.size()) == 0, "the image data round trips");
+
+	for (size_t size = 0; size < file.size(); size += 7) {
+		_check(!gltf_texture_cache_read(file.data(), size, entry), "a truncated entry is rejected");
+	}
+
+	std::vector<uint8_t> corrupt = file;
+	corrupt[GLTF_TEXTURE_CACHE_HEADER_SIZE + data.size() / 2] ^= 0x40;
+	_check(!gltf_texture_cache_read(corrupt.data(), corrupt.size(), entry), "an entry with damaged data is rejected");
+
+	corrupt = file;
+	corrupt[8] ^= 0x01;
+	_check(!gltf_texture_cache_read(corrupt.data(), corrupt.size(), entry), "an entry with a damaged header is rejected");
+
+	corrupt = file;
+	corrupt[4] ^= 0x01;
+	_check(!gltf_texture_cache_read(corrupt.data(), corrupt.size(), entry), "an entry of another version is rejected");
+
+	corrupt = file;
+	corrupt.push_back(0);
+	_check(!gltf_texture_cache_read(corrupt.data(), corrupt.size(), entry), "an entry with trailing bytes is rejected");
+
+	printf("test_texture_cache: %s\n", failures ? "FAILED" : "OK");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+/*************************************************************************/
+/*  thread_work_pool.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef THREAD_WORK_POOL_H
+#define THREAD_WORK_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadWorkPool {
+	// One do_work call. Helpers are the pool threads lending a hand to the
+	// caller; both counters are guarded by the pool mutex.
+	struct Batch {
+		std::function<void()> work;
+		int pending_helpers = 0;
+		int active_helpers = 0;
+	};
+
+	// Threads are started on first use and then kept, so short calls don't
+	// pay for spawning and joining workers every time.
+	struct Workers {
+		std::mutex mutex;
+		std::condition_variable work_available;
+		std::condition_variable helper_done;
+		std::deque<Batch *> queue;
+		std::vector<std::thread> threads;
+		bool exiting = false;
+
+		void loop() {
+			std::unique_lock<std::mutex> lock(mutex);
+			while (true) {
+				work_available.wait(lock, [this]() { return exiting || !queue.empty(); });
+				if (exiting) {
+					return;
+				}
+				Batch *batch = queue.front();
+				if (--batch->pending_helpers == 0) {
+					queue.pop_front();
+				}
+				batch->active_helpers++;
+				lock.unlock();
+				batch->work();
+				lock.lock();
+				if (--batch->active_helpers == 0) {
+					helper_done.notify_all();
+				}
+			}
+		}
+
+		void run(Batch &p_batch, int p_helpers) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				while ((int)threads.size() < p_helpers) {
+					threads.push_back(std::thread(&Workers::loop, this));
+				}
+				p_batch.pending_helpers = p_helpers;
+				queue.push_back(&p_batch);
+			}
+			work_available.notify_all();
+
+			// The caller drains the batch on its own if every worker is busy,
+			// which also keeps nested calls from waiting on each other.
+			p_batch.work();
+
+			std::unique_lock<std::mutex> lock(mutex);
+			if (p_batch.pending_helpers > 0) {
+				queue.erase(std::find(queue.begin(), queue.end(), &p_batch));
+				p_batch.pending_helpers = 0;
+			}
+			helper_done.wait(lock, [&p_batch]() { return p_batch.active_helpers == 0; });
+		}
+
+		void finish() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				exiting = true;
+			}
+			work_available.notify_all();
+			for (size_t i = 0; i < threads.size(); i++) {
+				threads[i].join();
+			}
+			threads.clear();
+			exiting = false;
+		}
+
+		~Workers() {
+			finish();
+		}
+	};
+
+	static Workers &get_workers() {
+		static Workers workers;
+		return workers;
+	}
+
+public:
+	// Number of workers used when a caller asks for 0 (automatic) threads.
+	static int get_default_thread_count() {
+		const int hardware_threads = (int)std::thread::hardware_concurrency();
+		return hardware_threads > 0 ? hardware_threads : 1;
+	}
+
+	// Calls p_func(i) for every i in [0, p_elements), spreading the indices over
+	// up to p_threads workers (0 or less picks the hardware concurrency). The
+	// calling thread takes part in the work and the call only returns once all
+	// elements have been processed. Indices are handed out in increasing order,
+	// so callers writing to r_results[i] get a stable output ordering.
+	template <class F>
+	static void do_work(int p_elements, int p_threads, F p_func) {
+		if (p_elements <= 0) {
+			return;
+		}
+		int thread_count = p_threads > 0 ? p_threads : get_default_thread_count();
+		thread_count = std::min(thread_count, p_elements);
+		if (thread_count <= 1) {
+			for (int i = 0; i < p_elements; i++) {
+				p_func(i);
+			}
+			return;
+		}
+
+		std::atomic<int> next_index(0);
+		Batch batch;
+		batch.work = [&]() {
+			while (true) {
+				const int i = next_index.fetch_add(1);
+				if (i >= p_elements) {
+					break;
+				}
+				p_func(i);
+			}
+		};
+		get_workers().run(batch, thread_count - 1);
+	}
+
+	// Joins the pool threads. Called when the library is unloaded, where
+	// static destructors may run too late to join safely; later calls to
+	// do_work start new threads.
+	static void finish() {
+		get_workers().finish();
+	}
+};
+
+#endif // THREAD_WORK_POOL_H